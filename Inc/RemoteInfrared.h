@@ -1,4 +1,5 @@
 #include "stm32f4xx_hal.h"
+#include "ir_decode.h"        // IR_REPEAT_GAP, IR_LONG_TICKS
 
 #define	Remote_Infrared_DAT_INPUT HAL_GPIO_ReadPin(GPIOF, GPIO_PIN_15)
 
@@ -16,5 +17,40 @@ typedef union _Remote_Infrared_data_union //
 	uint32_t uiRemoteInfraredData; 
 }Remote_Infrared_data_union;
 
+#define IR_QUEUE_LEN     8        // , 2 
+
+typedef enum
+{
+    IR_KEY_PRESS = 0,         //  (֡)
+    IR_KEY_REPEAT,            // ס, ÿظһ
+    IR_KEY_LONG               // ס IR_LONG_TICKS, ÿΰסֻһ
+} IR_Key_Type_t;
+
+typedef struct
+{
+    uint32_t tick;            // жһ֡ʱ (100us)
+    uint8_t  key;             // ߼: 0~9, KEYMAP_KEY_DEL
+    uint8_t  type;            // IR_Key_Type_t
+    uint8_t  remote_id;       // ңʶ, ƽⰴ
+    uint8_t  reserved;
+} IR_Key_Event_t;
+
+typedef struct
+{
+    uint32_t frames;          // ֡
+    uint32_t repeats;
+    uint32_t longs;
+    uint32_t overflow;        // ֡ ()
+    uint32_t orphan;          // ǰûаŵļظ, 
+    uint32_t errors;          // 뷴벻
+    uint32_t unknown;         // λû
+    uint8_t  depth;           // ǰ֡
+    uint8_t  depth_max;
+} IR_Stats_t;
+
 void Remote_Infrared_KEY_ISR(void);
-uint8_t Remote_Infrared_KeyDeCode(void);
+uint8_t Remote_Infrared_GetKey(IR_Key_Event_t *ev);
+uint8_t Remote_Infrared_Busy(void);
+uint8_t Remote_Infrared_Holding(void);
+void Remote_Infrared_GetStats(IR_Stats_t *st);
+uint8_t Remote_Infrared_LastID(void);
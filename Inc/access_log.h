@@ -0,0 +1,76 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __ACCESS_LOG_H
+#define __ACCESS_LOG_H
+
+/* ֻ stdint, ˽빤 (Tools/alog_dump.c) Ҳͷļ */
+#include <stdint.h>
+
+/* ¼ */
+typedef enum
+{
+    LOG_EVT_POWER_ON = 1,     // 
+    LOG_EVT_ARRIVE,           // 
+    LOG_EVT_ACCESS,           // У
+    LOG_EVT_CLOSE,            // բ
+    LOG_EVT_OBSTRUCT          // ת
+} AccessLog_Event_t;
+
+/*  */
+typedef enum
+{
+    LOG_OUT_NONE = 0,
+    LOG_OUT_GRANTED,          // ȷ, բ
+    LOG_OUT_DENIED,           // 
+    LOG_OUT_DEPARTED,         // ͨ
+    LOG_OUT_TIMEOUT,          // բʱ
+    LOG_OUT_REVERSED,         // բжת, ¿բ
+    LOG_OUT_STOPPED,          // բжת, ͣס
+    LOG_OUT_SCHEDULE          // ȷʱ
+} AccessLog_Outcome_t;
+
+/* һ¼ 16 ֽ, Flash ͵ﶼʽ (С) */
+typedef struct
+{
+    uint32_t seq;             // ¼, 1ʼ
+    uint32_t time;            // RTC ʱ, 1970-01-01 ; 0: ʱû
+    uint8_t  event;           // AccessLog_Event_t
+    uint8_t  keys;            // İ
+    uint8_t  outcome;         // AccessLog_Outcome_t
+    uint8_t  state;           // ¼ʱϵͳ״̬ (SystemState_t)
+    uint32_t crc;             // ǰ3ֵ CRC (STM32 CRC Ԫ㷨)
+} AccessLog_Record_t;
+
+/* : ֡ͷ + count ¼, ʱȺ */
+#define ALOG_DUMP_MAGIC     0x474F4C41u   // "ALOG"
+#define ALOG_DUMP_VERSION   2             // 1: time ϵͳ
+#define ALOG_DUMP_BAUD      500000        // PCLK2 8MHz, 16
+#define ALOG_DUMP_CMD       'L'           // յֽڿʼ
+
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t rec_size;        // sizeof(AccessLog_Record_t)
+    uint32_t count;
+    uint32_t crc;             // ǰ3ֵ CRC
+} AccessLog_Dump_Head_t;
+
+typedef struct
+{
+    uint32_t next_seq;
+    uint32_t stored;          // Flash еļ¼
+    uint16_t staged;          // SRAM ݴ, ûд Flash
+    uint16_t dropped;         // ݴ
+    uint32_t flushes;         // д Flash 
+    uint32_t erases;          // 
+    uint32_t init_us;         // λдָʱ
+} AccessLog_Stats_t;
+
+void AccessLog_Init(void);
+void AccessLog_Append(uint8_t event, uint8_t keys, uint8_t outcome, uint8_t state);
+void AccessLog_Task(uint8_t idle);       // ѭ; idle=1 ʱ
+uint8_t AccessLog_Dump_Start(void);      // ʼ, 0: ڵ
+uint8_t AccessLog_Dumping(void);         // ڼ printf , ʱλ
+void AccessLog_GetStats(AccessLog_Stats_t *st);
+
+#endif /* __ACCESS_LOG_H */
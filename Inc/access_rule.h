@@ -0,0 +1,31 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __ACCESS_RULE_H
+#define __ACCESS_RULE_H
+
+#include "stm32f4xx_hal.h"
+
+#define RULE_CODE_MAX          8       //  0 ~ RULE_CODE_MAX-1, Ŀǰֻ0
+#define RULE_WINDOW_MAX        5       // ÿ༸ʱ ( Flash ֵ, 3ֽһ)
+
+/* 1: ʱӻûʱ"ȫʱ", ֹû˽; 0: һɾܾ */
+#define RULE_UNSET_CLOCK_ALLOW 1
+
+/* days: bit0 һ ... bit6  */
+#define RULE_DAYS_ALL          0x7F
+#define RULE_DAYS_WORKDAY      0x1F
+#define RULE_DAYS_WEEKEND      0x60
+
+/* һʱ: days ÿһ [start, end) . start > end ʾҹڶ, start == end ʾȫ */
+typedef struct
+{
+    uint8_t days;
+    uint8_t start;
+    uint8_t end;
+} Rule_Window_t;
+
+void Rule_Init(void);                                                    // Ӽֵչ
+uint8_t Rule_Set(uint8_t code, const Rule_Window_t *win, uint8_t n);     // n=0: ָȫʱ
+uint8_t Rule_Allowed(uint8_t code, uint8_t weekday, uint8_t hour);       // weekday: 1 һ .. 7 
+uint8_t Rule_Check(uint8_t code);                                        // ǰʱж
+
+#endif /* __ACCESS_RULE_H */
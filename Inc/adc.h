@@ -48,6 +48,14 @@
 extern ADC_HandleTypeDef hadc3;
 
 /* USER CODE BEGIN Private defines */
+extern DMA_HandleTypeDef hdma_adc3;
+
+/* Index of each channel in the regular scan sequence (DMA buffer order) */
+#define ADC_IDX_LIGHT      0   /* PF6 ADC3_IN4 : light sensor */
+#define ADC_IDX_PRESENCE   1   /* PF7 ADC3_IN5 : vehicle presence sensor */
+#define ADC_IDX_SERVO_FB   2   /* PF8 ADC3_IN6 : servo feedback potentiometer */
+#define ADC_IDX_SERVO_CUR  3   /* PF9 ADC3_IN7 : servo supply current sense */
+#define ADC_SEQ_LEN        4
 
 /* USER CODE END Private defines */
 
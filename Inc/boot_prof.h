@@ -0,0 +1,52 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __BOOT_PROF_H
+#define __BOOT_PROF_H
+
+#include "stm32f4xx_hal.h"
+
+/* ׶, ÿ׶νʱһʱ; ˳ main() һ,  */
+typedef enum
+{
+    BOOT_STAGE_CLOCK = 0,    // HAL_Init + SystemClock_Config
+    BOOT_STAGE_OUTPUT,       // GPIO + SRAM , LED/̵ѻָ
+    BOOT_STAGE_DMA,
+    BOOT_STAGE_TIM12,
+    BOOT_STAGE_I2C1,
+    BOOT_STAGE_USART1,
+    BOOT_STAGE_TIM7,
+    BOOT_STAGE_ADC3,
+    BOOT_STAGE_RNG,          // Ӳ, سصһ
+    BOOT_STAGE_KV,           // Flash ֵؽ
+    BOOT_STAGE_RTC,
+    BOOT_STAGE_RULE,
+    BOOT_STAGE_RESTORE,      // SysData_Init: /״ָ̬
+    BOOT_STAGE_SERVO,        // Servo_Init + Obstruct_Init
+    BOOT_STAGE_SENSE,        // Presence_Init + Light_Init
+    BOOT_STAGE_LOG,          // AccessLog_Init
+    BOOT_STAGE_IWDG,
+    BOOT_STAGE_LOOP,         // һѭ, ⰴʼ
+    BOOT_STAGE_DEFER,        // ƳٵʾˢºͿϢ
+    BOOT_STAGE_NUM
+} Boot_Stage_t;
+
+/* һļ¼, ڱSRAM, ´ʱӡ */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t boots;            // ۼ (縴λ)
+    uint8_t  hot;              // 
+    uint8_t  resumed;          // ɶʱλ
+    uint16_t reserved;
+    uint32_t pre_main_us;      // λ -> main(), ֻмʱ֪, Ϊ0
+    uint32_t stamp_us[BOOT_STAGE_NUM];   //  main() ʼ
+    uint32_t crc;
+} Boot_Prof_t;
+
+/* ʱȡ DWT ڼ, main() ͷ DWT_Cycle_Init ʼ */
+void BootProf_Mark(Boot_Stage_t stage);
+void BootProf_Finish(uint8_t hot, uint8_t resumed, uint32_t pre_main_us);   // 뱸SRAM, һεļ¼ Report
+uint8_t BootProf_GetLast(Boot_Prof_t *prof);           // һļ¼, 0: û
+void BootProf_Summary(void);                           // һ: һõʱ
+void BootProf_Report(void);                            // ӡһĸ׶κʱ
+
+#endif /* __BOOT_PROF_H */
@@ -0,0 +1,12 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CRC32_SW_H
+#define __CRC32_SW_H
+
+#include <stdint.h>
+
+/*  STM32 Ӳ CRC Ԫ (CRC_Calc32) һµʵ.
+ * ֻ stdint.h, λ/PC У鱸ݡ־ʱֱļ.
+ * ˶ֵ: { 0x12345678 } -> 0xDF8A8A2B, { 0x12345678, 0x9ABCDEF0 } -> 0x7D24A31B */
+uint32_t Crc32_Sw(const uint32_t *buf, uint32_t words);
+
+#endif /* __CRC32_SW_H */
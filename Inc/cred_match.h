@@ -0,0 +1,23 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CRED_MATCH_H
+#define __CRED_MATCH_H
+
+#include <stdint.h>
+
+/* ûһ, 16 ֽ, һ KV ¼ */
+typedef struct
+{
+    uint32_t code;          // 8 λ, ÿλһ BCD ֽ (Cred_Pack)
+    uint16_t owner;         // û
+    uint8_t  flags;         // CRED_FLAG_xxx
+    uint8_t  rule;          // ʱι (access_rule), 0 ~ RULE_CODE_MAX-1
+    uint32_t expiry;        // ʱ (RTC_Now ), 0: 
+    uint32_t uses;          // ʹô
+} Cred_Entry_t;
+
+#define CRED_FLAG_ENABLED   0x01
+
+uint32_t Cred_Pack(const uint8_t *digits);   // 8  (0~9) -> BCD
+int32_t Cred_Match(const Cred_Entry_t *tab, uint32_t n, uint32_t code, uint32_t now);   // ظ, -1: û
+
+#endif /* __CRED_MATCH_H */
@@ -0,0 +1,29 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CRED_STORE_H
+#define __CRED_STORE_H
+
+#include "stm32f4xx_hal.h"
+#include "cred_match.h"
+
+#define CRED_MAX            256     // ĸ, һһ KV  (KV_KEY_CRED_BASE ҳ)
+
+/* 1: ӡ 10/100/1000 ƥʱ (DWT), Ҫռ 16KB RAM; 0:  */
+#define CRED_BENCH_ENABLE   0
+
+typedef struct
+{
+    uint16_t count;                 // ø
+    uint32_t verify_cycles;         // һ֤
+    uint32_t verify_max_cycles;
+} Cred_Stats_t;
+
+void Cred_Init(void);                                       // KV_Init ֮: Ӽֵ
+int16_t Cred_Verify(const uint8_t *digits, uint32_t now);   // 8 λ, ظ, -1: ͨ
+uint8_t Cred_Get(uint16_t idx, Cred_Entry_t *e);
+uint8_t Cred_Set(uint16_t idx, const Cred_Entry_t *e);
+uint8_t Cred_Delete(uint16_t idx);
+void Cred_Used(uint16_t idx);                               // ź: ʹôһ
+void Cred_GetStats(Cred_Stats_t *st);
+void Cred_Bench(void);
+
+#endif /* __CRED_STORE_H */
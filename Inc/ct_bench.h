@@ -0,0 +1,39 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CT_BENCH_H
+#define __CT_BENCH_H
+
+#include <stdint.h>
+
+#define CT_LEN_MAX        32      // Ƚֽ (SHA-256 ժҪ)
+#define CT_T_THRESHOLD    4.5     // |t| Ϊǰ׺й (dudect/TVLA )
+#define CT_WARMUP         1000    // Ԥ, Ⱥֵ
+
+typedef uint8_t (*Ct_Fn_t)(const uint8_t *a, const uint8_t *b, uint32_t n);
+typedef uint32_t (*Ct_Clock_t)(void);
+
+/* һͳ (Welford) */
+typedef struct
+{
+    uint32_t n;
+    uint32_t min;
+    uint32_t max;
+    double   mean;
+    double   m2;              // ƽ
+} Ct_Acc_t;
+
+typedef struct
+{
+    uint32_t len;                       // Ƚϳ
+    uint32_t cutoff;                    //  (ж, ȱʧ)
+    uint32_t dropped;
+    Ct_Acc_t bucket[CT_LEN_MAX + 1];    // ǰ׺ƥ䳤ȷ, len ȫ
+    double   t_max;                     //  0  Welch t, ֵ
+    uint32_t t_len;                     // һ
+} Ct_Result_t;
+
+void Ct_Bench_Run(Ct_Result_t *res, Ct_Fn_t fn, uint32_t len, uint32_t samples,
+                  Ct_Clock_t clock, uint32_t seed, void (*yield)(void));
+double Ct_Welch_T(const Ct_Acc_t *a, const Ct_Acc_t *b);
+uint8_t Ct_Compare_Early(const uint8_t *a, const uint8_t *b, uint32_t n);   // : ǰ˳
+
+#endif /* __CT_BENCH_H */
@@ -0,0 +1,12 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CT_COMPARE_H
+#define __CT_COMPARE_H
+
+#include <stdint.h>
+
+/* Ƚ, ȷ 1. ʱֻ n й, ʹӵڼֽڿʼͬ޹
+ * (Tools/ct_bench.c  PWD_CT_BENCH_ENABLE  Welch t ˶) */
+uint8_t Ct_Compare_Xor(const uint8_t *a, const uint8_t *b, uint32_t n);   // 㷨A:  XOR
+uint8_t Ct_Compare_Sub(const uint8_t *a, const uint8_t *b, uint32_t n);   // 㷨B: 
+
+#endif /* __CT_COMPARE_H */
@@ -0,0 +1,62 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DOOR_FSM_H
+#define __DOOR_FSM_H
+
+/* ֻ stdint, ģԹ (Tools/ir_fuzz.c) Ҳ door_fsm.c һ */
+#include <stdint.h>
+
+#define DOOR_PWD_LEN          8
+#define DOOR_KEY_DEL          0x78        //  main.c  KEY_DEL, KEYMAP_KEY_DEL һ
+#define DOOR_KEY_NONE         0xFF
+#define DOOR_BLANK            14          // ûλ ()
+
+#define OPEN_TIMEOUT_TICKS    50000       // բ޳ʱĿųʱ (100us tick, 5s)
+#define OPEN_HOLD_MAX_TICKS   600000      // ͣբʱ (60s)
+#define ERR_HOLD_TICKS        20000       //  2s ش
+#define INPUT_TIMEOUT_TICKS   300000      // 䵽һ 30s û, ش
+
+typedef enum
+{
+    SYS_IDLE = 0,        // 
+    SYS_INPUT_PWD,       // ing
+    SYS_VERIFY,          // ֤
+    SYS_OPEN,            // ing
+    SYS_ERROR            // 
+} SystemState_t;
+
+typedef struct
+{
+    uint8_t  state;                     // SystemState_t
+    uint8_t  input_index;               // λ, 0 ~ DOOR_PWD_LEN
+    uint8_t  input_buf[DOOR_PWD_LEN];   // ûλ DOOR_BLANK
+    uint32_t key_tick;                  // һΰ
+    uint32_t verify_due;                // ʱ̲ųУ
+    uint32_t open_tick;                 // բʱ
+    uint32_t err_tick;                  // ʼʱ
+} Door_Fsm_t;
+
+/* һѭ */
+typedef struct
+{
+    uint32_t now;             // 100us tick
+    uint8_t  key;             // : 0~9, DOOR_KEY_DEL; û: DOOR_KEY_NONE
+    uint8_t  key_long;        // , ͬ
+    uint8_t  departed;        // 뿪 (PRESENCE_EVT_DEPARTED)
+    uint8_t  vehicle;         // բг
+} Door_Input_t;
+
+/* Door_Step صĶ: ״̬Ӳ, ÷ */
+#define DOOR_ACT_BEEP         (1u << 0)   // 
+#define DOOR_ACT_BEEP_LONG    (1u << 1)   // 
+#define DOOR_ACT_INPUT        (1u << 2)   // 뻺: ˢʾ, 汸
+#define DOOR_ACT_STATE        (1u << 3)   // ״̬: 汸
+#define DOOR_ACT_VERIFY       (1u << 4)   // óУ, У Door_Verdict
+#define DOOR_ACT_CLOSE        (1u << 5)   // Ž, բ
+
+void Door_Init(Door_Fsm_t *d);
+void Door_Enter(Door_Fsm_t *d, uint8_t state, uint32_t now);   // ֱӽĳ״̬ (, ת)
+uint32_t Door_Step(Door_Fsm_t *d, const Door_Input_t *in);
+uint32_t Door_Verdict(Door_Fsm_t *d, uint8_t granted, uint32_t now);
+void Door_Clear(Door_Fsm_t *d);
+
+#endif /* __DOOR_FSM_H */
@@ -0,0 +1,13 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DWT_H
+#define __DWT_H
+
+#include "stm32f4xx_hal.h"
+
+/* DWT ڼ, ڲִʱ (HCLK ) */
+#define DWT_CYCCNT_GET()   (DWT->CYCCNT)
+
+void DWT_Cycle_Init(void);
+uint32_t DWT_Cycle_To_Us(uint32_t cycles);
+
+#endif /* __DWT_H */
@@ -0,0 +1,36 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __ENTROPY_H
+#define __ENTROPY_H
+
+#include <stdint.h>
+
+#define ENTROPY_POOL_WORDS   32      //  (), 2 
+
+typedef void (*Entropy_Refill_t)(void);     // ӲŲ ()
+typedef uint32_t (*Entropy_Clock_t)(void);  // ʱ (), ֻͳ
+
+typedef struct
+{
+    uint32_t depth;           // 
+    uint32_t low_water;       // ٵʱ
+    uint32_t pushed;          // Ӳͽ
+    uint32_t drawn;           // ȡߵ ()
+    uint32_t underruns;       // ؿ, ú󱸷Ĵ
+    uint32_t repeats;         // ͬ (FIPS 140-2 )
+    uint32_t errors;          // Ӳʱ/Ӵ
+    uint32_t refill_words;    // һδӿʼ
+    uint32_t refill_cycles;   // һβõʱ
+    uint32_t refill_max_cycles;
+} Entropy_Stats_t;
+
+/* refill Ϊվ/õȷ԰汾: ȫȡ seed ֵ xorshift */
+void Entropy_Init(Entropy_Refill_t refill, Entropy_Clock_t clock, uint32_t seed);
+void Entropy_Push(uint32_t w);       // Ӳжһ
+uint8_t Entropy_Full(void);
+void Entropy_Error(void);            // Ӳ, һ¿ʼ
+uint32_t Entropy_U32(void);          // , ؿʱߺ
+uint32_t Entropy_Range(uint32_t lo, uint32_t hi);   // [lo, hi]
+void Entropy_Fill(uint8_t *buf, uint32_t len);      // ,  (nonce)
+void Entropy_GetStats(Entropy_Stats_t *st);
+
+#endif /* __ENTROPY_H */
@@ -0,0 +1,68 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __FAULT_H
+#define __FAULT_H
+
+#include "stm32f4xx_hal.h"
+
+/*  */
+typedef enum
+{
+    FAULT_NONE = 0,
+    FAULT_HARD,
+    FAULT_MEMMANAGE,
+    FAULT_BUS,
+    FAULT_USAGE,
+    FAULT_INIT              // ʼʧ (¼, û쳣ջ֡), code  Fault_Record
+} Fault_Type_t;
+
+/* ¼,  FAULT_TRACE_LEN ڱSRAM */
+typedef enum
+{
+    FAULT_TRC_BOOT = 1,     // arg: 1 
+    FAULT_TRC_STATE,        // arg: SystemState_t
+    FAULT_TRC_KEY,          // arg: 
+    FAULT_TRC_PRESENCE,     // arg: Presence_Event_t
+    FAULT_TRC_SERVO,        // arg: Servo_Event_t
+    FAULT_TRC_WATCHDOG      // arg: ʱ Sup_Task_t
+} Fault_Trace_Id_t;
+
+#define FAULT_TRACE_LEN   16   // 2 
+
+/* ʼʧܵλ (FAULT_INIT  code) */
+#define FAULT_INIT_IWDG   1
+
+typedef struct
+{
+    uint32_t tick;
+    uint16_t id;            // Fault_Trace_Id_t
+    uint16_t arg;
+} Fault_Trace_t;
+
+/* ֳ, SRAM ֻһ */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t count;         // ۼ (縴λ)
+    uint32_t reported;      // Ѿ count
+    uint32_t type;          // Fault_Type_t
+    uint32_t frame[8];      // 쳣ջ֡: R0 R1 R2 R3 R12 LR PC xPSR
+    uint32_t sp;            // ջַ֡
+    uint32_t exc_return;
+    uint32_t cfsr;
+    uint32_t hfsr;
+    uint32_t mmfar;
+    uint32_t bfar;
+    uint32_t tick;
+    uint8_t  state;         // µ SystemState_t
+    uint8_t  trace_head;    // ʱٻдλ
+    uint16_t code;          // FAULT_INIT ĳλ
+} Fault_Dump_t;
+
+void Fault_Init(void);                                  // Persist_Init ֮: ༸ Fault, ٻ
+void Fault_Trace(Fault_Trace_Id_t id, uint16_t arg);   // , ѭ
+void Fault_Capture(uint32_t *frame, uint32_t type, uint32_t exc_return);   //  xxx_Handler ת, 
+void Fault_Record(uint16_t code);                       // ʼʧ: һ FAULT_INIT λ, 
+void Fault_Report(void);                                // ӡµ¼
+uint32_t Fault_Count(void);
+
+#endif /* __FAULT_H */
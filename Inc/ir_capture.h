@@ -0,0 +1,44 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __IR_CAPTURE_H
+#define __IR_CAPTURE_H
+
+/* ֻ stdint, ˻طŹ (Tools/ir_replay.c) Ҳͷļ */
+#include <stdint.h>
+
+#define IR_CAP_LEN           2048          // ı (4KB RAM)
+#define IR_CAP_HOLD_TICKS    300000        // ץʼ 30s ʱλ, ˾Ͳ
+#define IR_CAP_START_CMD     'E'           // յֽղʼץ
+#define IR_CAP_DUMP_CMD      'F'           // ֹͣץ
+
+/* һ 16 λ: bit0 غĵƽ, bit15..1 һص us (ⶥ IR_CAP_DT_MAX) */
+#define IR_CAP_DT_MAX        0x7FFFu
+#define IR_CAP_ENTRY(dt_us, level) \
+    ((uint16_t)((((dt_us) > IR_CAP_DT_MAX ? IR_CAP_DT_MAX : (dt_us)) << 1) | ((level) ? 1u : 0u)))
+#define IR_CAP_DT(e)         ((uint32_t)(e) >> 1)
+#define IR_CAP_LEVEL(e)      ((uint8_t)((e) & 1u))
+
+/*  (, 115200, С): ֡ͷ + count , ʱȺ.
+ *  .irc ļҲʽ */
+#define IR_CAP_MAGIC         0x50435249u   // "IRCP"
+#define IR_CAP_VERSION       1
+
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;           // 
+    uint32_t dropped;         // Ժûµı
+    uint32_t data_crc;        // ݰ CRC, ʱĩβ 0
+    uint32_t crc;             // ǰ4ֵ CRC (STM32 CRC Ԫ㷨)
+} IR_Capture_Head_t;
+
+typedef char ir_cap_head_check[(sizeof(IR_Capture_Head_t) == 20) ? 1 : -1];
+
+void IR_Capture_Edge(uint8_t level, uint32_t dt_us);   // жÿص
+void IR_Capture_Start(void);
+uint8_t IR_Capture_Dump_Start(void);   // ֹͣץʼ, 0: ڵ
+void IR_Capture_Task(void);            // ѭ, ʱһֽһֽ
+uint8_t IR_Capture_Busy(void);         // ץ/ڼ䲻ʱλ
+uint8_t IR_Capture_Dumping(void);      // ڼ printf 
+
+#endif /* __IR_CAPTURE_H */
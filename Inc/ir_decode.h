@@ -0,0 +1,64 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __IR_DECODE_H
+#define __IR_DECODE_H
+
+/* ֻ stdint, ˻ط/ģԹ (Tools/ir_replay.c, ir_fuzz.c) Ҳ ir_decode.c һ */
+#include <stdint.h>
+
+/* NEC Ľܴ (us, ), ԭж 100us ʱжһ */
+#define IR_DEC_LEAD_MIN       8200    // 9ms ͵ƽ
+#define IR_DEC_LEAD_MAX       9800
+#define IR_DEC_SPACE_MIN      4000    // 4.5ms ߵƽ: 
+#define IR_DEC_SPACE_MAX      5500
+#define IR_DEC_REPEAT_MIN     1400    // 2.25ms: ظ
+#define IR_DEC_REPEAT_MAX     2800
+#define IR_DEC_BIT_MIN        200     // 560us ز / '0' ļ
+#define IR_DEC_BIT_MAX        1000
+#define IR_DEC_ONE_MIN        1200    // 1690us: '1' ļ
+#define IR_DEC_ONE_MAX        2000
+
+#define IR_DEC_EDGES          67      //  3  + 32 λ * 2
+
+typedef enum
+{
+    IR_DEC_NONE = 0,
+    IR_DEC_FRAME,             // һ֡, code  Remote_Infrared_data_union ֵ
+    IR_DEC_REPEAT             // ظ
+} IR_Dec_Result_t;
+
+typedef struct
+{
+    uint8_t  edges;           // һ֡Ѿյı, 0: 
+    uint32_t code;            // յλ, λȵ
+} IR_Decoder_t;
+
+/* ֡ -> : סֻظ, ʱ鵽ŵļ (100us tick) */
+#define IR_REPEAT_GAP         1500    // ظ: NEC סÿ 108ms һ,  150ms ɿ
+#define IR_LONG_TICKS         8000    // ס 0.8s 㳤
+#define IR_HOLD_NONE          0xFF    // ûаŵļ ( KEYMAP_KEY_NONE һ)
+
+typedef enum
+{
+    IR_HOLD_ORPHAN = 0,       // ǰûаŵļ, ߸̫, 
+    IR_HOLD_REPEAT,           // ס
+    IR_HOLD_LONG              // ס IR_LONG_TICKS, ÿΰסֻһ
+} IR_Hold_Result_t;
+
+typedef struct
+{
+    uint8_t  key;             // ŵļ, IR_HOLD_NONE: û
+    uint8_t  id;              // ңʶ
+    uint8_t  long_sent;       // ΰסѾ
+    uint32_t press_tick;
+    uint32_t last_tick;       // һ֡/һظ
+} IR_Hold_t;
+
+void IR_Decode_Reset(IR_Decoder_t *d);
+/* ÿصһ: level Ǳ֮ PF15 ĵƽ, dt_us һصʱ */
+uint8_t IR_Decode_Edge(IR_Decoder_t *d, uint8_t level, uint32_t dt_us, uint32_t *code);
+/* ֡: Э ( KEYMAP_PROTO_NEC/NECX һ), 0: 뷴벻 */
+uint8_t IR_Decode_Split(uint32_t raw, uint16_t *addr, uint8_t *cmd);
+void IR_Hold_Press(IR_Hold_t *h, uint8_t key, uint8_t id, uint32_t tick);   // key Ϊ IR_HOLD_NONE ɿ
+uint8_t IR_Hold_Repeat(IR_Hold_t *h, uint32_t tick);                        //  IR_Hold_Result_t
+
+#endif /* __IR_DECODE_H */
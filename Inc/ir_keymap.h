@@ -0,0 +1,51 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __IR_KEYMAP_H
+#define __IR_KEYMAP_H
+
+#include "stm32f4xx_hal.h"
+
+#define KEYMAP_SLOTS        64      // Ѱַ, 2 , һһ KV 
+#define KEYMAP_MAX          48      // ô, װʲ 3/4
+#define KEYMAP_LEARN_NUM    11      // ѧϰʱΰ 0~9, DEL
+#define KEYMAP_LEARN_TICKS  300000  // ѧϰʱ 30s ûͷ (100us tick)
+
+#define KEYMAP_KEY_DEL      0x78    //  main.c  KEY_DEL һ
+#define KEYMAP_KEY_NONE     0xFF
+
+/* Э: 0 ֻĬϱ, ʾַܵ */
+#define KEYMAP_PROTO_ANY    0
+#define KEYMAP_PROTO_NEC    1       // 8 λַ + 
+#define KEYMAP_PROTO_NECX   2       // NEC չ, 16 λַ
+
+#define KEYMAP_CODE(proto, addr, cmd) \
+    (((uint32_t)(proto) << 24) | ((uint32_t)(addr) << 8) | (uint8_t)(cmd))
+
+/* һ (8 ֽ), code Ϊ 0 ǿո */
+typedef struct
+{
+    uint32_t code;            // KEYMAP_CODE(Э, ַ, )
+    uint8_t  key;             // ߼: 0~9, KEYMAP_KEY_DEL
+    uint8_t  reserved[3];
+} Keymap_Entry_t;
+
+typedef struct
+{
+    uint16_t count;           // ѧ (Ĭ)
+    uint8_t  factory;         // ûѧ, õǳĬϱ
+    uint8_t  probe_max;       // ̽˼
+    uint32_t lookups;
+    uint32_t lookup_cycles;   // һβ
+    uint32_t lookup_max_cycles;
+} Keymap_Stats_t;
+
+void Keymap_Init(void);                                  // KV_Init ֮: Ӽֵ
+uint8_t Keymap_Lookup(uint32_t code);                    // ߼, KEYMAP_KEY_NONE: û
+uint8_t Keymap_Learn_Start(void);
+uint8_t Keymap_Learning(void);
+void Keymap_Learn_Feed(uint32_t code);                   // ѧϰյÿЧ֡
+void Keymap_Task(void);                                  // ѭ: ѧϰʱ
+uint16_t Keymap_Forget(uint16_t addr);                   // ɾĳң (ַ) ȫ, 
+void Keymap_Report(void);
+void Keymap_GetStats(Keymap_Stats_t *st);
+
+#endif /* __IR_KEYMAP_H */
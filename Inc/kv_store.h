@@ -0,0 +1,39 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __KV_STORE_H
+#define __KV_STORE_H
+
+#include "stm32f4xx_hal.h"
+
+/* : 0 ~ KV_KEY_MAX-1, , õĺŲҪ.
+ * ֽҳ: 0 ҳŵ, ҳҳһű (һһ) */
+#define KV_KEY_PASSWORD        0x000   // ɰ, ժҪɾ (pwd_hash)
+#define KV_KEY_PWD_SALT        0x002   //  (16 ֽ)
+#define KV_KEY_PWD_DIGEST      0x003   // 0x03~0x04: ժҪǰ 16 ֽ
+#define KV_KEY_LOCKOUT         0x005   // ȫ (Lock_Flash_t), ϵҲҪ
+#define KV_KEY_SERVO_PROFILE   0x001   // ˶߲ (Servo_Profile_t)
+#define KV_KEY_RULE_BASE       0x010   // 0x10~0x17: ʱι (Rule_Window_t[])
+#define KV_KEY_CRED_BASE       0x100   // 1 ҳ: û, ÿһ (Cred_Entry_t)
+#define KV_KEY_VISITOR_BASE    0x200   // 2 ҳ: ÿ TOTP, ÿ (Կǰ 16 ֽ, Visitor_Meta_t)
+#define KV_KEY_KEYMAP_BASE     0x300   // 3 ҳǰ 64 : λϣ, ÿһ (Keymap_Entry_t)
+#define KV_KEY_MAX             0x340
+
+#define KV_VALUE_MAX           16      // ֵֽ
+
+typedef struct
+{
+    uint32_t gen;             // ǰ, ÿһ
+    uint16_t used;            // ü¼λ (ɰ汾ͻ¼)
+    uint16_t capacity;        // һļ¼λ
+    uint16_t keys;            // Ч
+    uint16_t bad;             // ɨʱ CRC Եļ¼
+    uint32_t index_us;        // ؽʱ
+    uint32_t gc_count;        // ϵ
+} KV_Stats_t;
+
+void KV_Init(void);                                         // : ؽ
+uint8_t KV_Get(uint16_t key, void *buf, uint8_t size);       // ֵ, 0: û
+uint8_t KV_Set(uint16_t key, const void *val, uint8_t len);  // 1: д (ֵûҲ)
+uint8_t KV_Delete(uint16_t key);
+void KV_GetStats(KV_Stats_t *st);
+
+#endif /* __KV_STORE_H */
@@ -0,0 +1,25 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __LIGHT_CTRL_H
+#define __LIGHT_CTRL_H
+
+#include "stm32f4xx_hal.h"
+
+/* 1: ͻ + FFT 100/120HzƵ˸, չ͵ƹ; 0: ֻõѹֵ */
+#define LIGHT_FLICKER_ENABLE   1
+
+typedef enum
+{
+    LIGHT_DARK = 0,      // 
+    LIGHT_DAYLIGHT,      // , ˸ -> չ
+    LIGHT_ARTIFICIAL     // , йƵ˸ -> ƹ
+} Light_Class_t;
+
+void Light_Init(uint8_t is_hot_start);
+void Light_Save(void);
+void Light_Sample(uint16_t sample);     // ADCже
+void Light_Task(void);                  // ѭ̨, 
+Light_Class_t Light_GetClass(void);
+uint8_t Light_NeedLamp(void);           // ǷҪ̵
+void Light_GetFftStats(uint32_t *last_cycles, uint32_t *max_cycles);
+
+#endif /* __LIGHT_CTRL_H */
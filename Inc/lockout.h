@@ -0,0 +1,37 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __LOCKOUT_H
+#define __LOCKOUT_H
+
+#include "stm32f4xx_hal.h"
+
+#define LOCK_SRC_NUM        5       // 0: ȫ, 1~4: ң ( Persist_Lock_t һ)
+#define LOCK_SRC_GLOBAL     0
+#define LOCK_FAILS          3       // ͬһң
+#define LOCK_GLOBAL_FAILS   10      // ңȫ (ʶƲȥ)
+#define LOCK_BASE_S         300     // һ 5 , ֮ÿη
+#define LOCK_MAX_S          (24 * 3600)
+
+typedef struct
+{
+    uint32_t remain_s;        // ȫʣ, 0: û
+    uint8_t  fails;           // ȫʧܴ
+    uint8_t  level;           // ȫ
+    uint8_t  sources;         // ڼң
+    uint8_t  sources_locked;  // ŵ
+    uint32_t lockouts;
+    uint32_t rejected;
+    uint32_t slept_ms;
+} Lock_Stats_t;
+
+void Lockout_Init(uint8_t is_hot_start);     // KV_Init, MX_RTC_Init ֮
+uint8_t Lockout_Blocked(uint8_t remote_id);  // 1: , ֱӶ
+uint32_t Lockout_Fail(uint8_t remote_id);    // һʧ, δ, 0: û
+void Lockout_Success(uint8_t remote_id);
+void Lockout_Task(void);                     // ѭ: ʱ
+void Lockout_Save(void);                     // ʱλǰ
+uint8_t Lockout_Global(void);
+void Lockout_Sleep(void);                    // ȫʱѭĩβ, WFI һж
+void Lockout_GetStats(Lock_Stats_t *st);
+void Lockout_Report(void);                   // ڴӡԴ״̬
+
+#endif /* __LOCKOUT_H */
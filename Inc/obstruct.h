@@ -0,0 +1,28 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __OBSTRUCT_H
+#define __OBSTRUCT_H
+
+#include "stm32f4xx_hal.h"
+
+/* 1: ת + Զ (ADC3_IN7, PF9); 0: ر */
+#define OBSTRUCT_ENABLE   1
+
+/* һζתļ¼ */
+typedef struct
+{
+    int8_t   dir;             // ʱĶ: 1 բ, -1 բ
+    uint8_t  over_bound;      // ӳٳ֤Ͻ
+    uint16_t current_ma;      // жڵƽ
+    uint16_t periods;         // ޵PWM
+    uint32_t latency_us;      // һ޲ -> ָ
+    uint32_t max_latency_us;  // ϵӳ
+    uint32_t bound_us;        // ֤ӳϽ
+    uint32_t count;           // ϵ
+} Obstruct_Report_t;
+
+void Obstruct_Init(void);
+void Obstruct_Sample(uint16_t adc);     // ADCже
+void Obstruct_Period_ISR(void);         // TIM12 же,  Servo_Ctrl_ISR ֮ǰ
+void Obstruct_GetReport(Obstruct_Report_t *rep);
+
+#endif /* __OBSTRUCT_H */
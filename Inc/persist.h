@@ -0,0 +1,137 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PERSIST_H
+#define __PERSIST_H
+
+#include "stm32f4xx_hal.h"
+
+/* SRAM (4KB)  */
+#define BKPSRAM_PERSIST_ADDR   (BKPSRAM_BASE + 0x000)   // ״̬ A/B,  1KB
+#define BKPSRAM_LOG_ADDR       (BKPSRAM_BASE + 0x800)   // ־ݴ, 1KB
+#define BKPSRAM_BOOT_ADDR      (BKPSRAM_BASE + 0xC00)   // һĸ׶ʱ, 256B
+#define BKPSRAM_FAULT_ADDR     (BKPSRAM_BASE + 0xD00)   // ֳ + ٻ, 512B
+#define BKPSRAM_FAULT_SIZE     0x200
+#define BKPSRAM_PSTAT_ADDR     (BKPSRAM_BASE + 0xF00)   // д (), 32B
+#define BKPSRAM_WDG_ADDR       (BKPSRAM_BASE + 0xF20)   // Źලͳ (), 96B
+#define BKPSRAM_FREE_ADDR      (BKPSRAM_BASE + 0xF80)   // δ, 128B
+
+/* ṹиĶ(ɾֶ/˳)ͼһ, ɰ汾հ */
+#define PERSIST_VERSION   9
+
+/* ṹСҪ4ֽڵ (CRC) */
+
+/* Ž״̬ */
+typedef struct
+{
+    uint8_t input_buf[8];     // 뵽һ (뱾ֻ Flash ժҪ)
+    uint8_t state;            // SystemState_t
+    uint8_t input_index;
+    uint8_t reserved[2];
+} Persist_Sys_t;
+
+/*  */
+typedef struct
+{
+    float   mean;
+    float   var;
+    float   s_hi;
+    float   s_lo;
+    uint8_t valid;            // Ч (ܻѧ)
+    uint8_t vehicle;
+    uint16_t learn_cnt;       // ѧ,  PRS_LEARN_SAMPLES ſʼ
+} Persist_Presence_t;
+
+/*  */
+typedef struct
+{
+    uint8_t valid;
+    uint8_t light_class;      // Light_Class_t
+    uint16_t since_last;      // ϴηλѹȥ tick, ⶥһ
+} Persist_Light_t;
+
+/*  */
+typedef struct
+{
+    uint8_t  valid;
+    uint8_t  shape;           // ˶߲,  Servo_Profile_t
+    uint8_t  max_vel;
+    uint8_t  accel;
+    uint16_t position;        // λǰıȽֵ (us)
+    uint16_t move_from;       // λʱڲ: , յ (us)
+    uint16_t move_to;
+    uint16_t move_idx;        // һҪֵ, 0: ûڲ
+} Persist_Servo_t;
+
+/* ʱλ: λǰͼʱ, λԭ, ûλ */
+typedef struct
+{
+    uint32_t open_elapsed;    // ѹȥ tick
+    uint32_t err_elapsed;     // ѹȥ tick
+    uint32_t led_elapsed;     // Ʊѹȥ tick
+    uint32_t key_elapsed;     // ϴΰѹȥ tick (볬ʱ)
+    uint32_t reset_cycles;    // λǰһ̵ DWT  (ϵͳλ), 㸴λʱ
+    uint8_t  valid;           // ֻڶʱλǰ1, ָ
+    uint8_t  led_count;       // λ
+    uint8_t  led_mask;        // ŵ LED, λͬ Turn_On_LED
+    uint8_t  relay;
+    uint8_t  display[8];      // ܵǰ ()
+} Persist_Ckpt_t;
+
+/* ÿһ: ùĲ, ͬһﲻõڶ */
+typedef struct
+{
+    uint32_t last_step[8];    // ÿÿ (VISITOR_MAX) һοõĲ, 0: ûù
+} Persist_Visitor_t;
+
+/* ƽ: Դʧܴʣʱ, 0 ȫ (lockout.c) */
+typedef struct
+{
+    uint32_t remain[5];       // ʣ tick (100us), 0: û (LOCK_SRC_NUM)
+    uint8_t  id[5];           // Դ: ңʶ
+    uint8_t  fails[5];        // ʧܴ
+    uint8_t  level[5];        // , һ
+    uint8_t  used;            // ռõԴ, λ
+    uint32_t lockouts;        // ۼ
+    uint32_t rejected;        // ڼ䶪İ
+    uint32_t slept_ms;        // ȫڼ WFI ˯ʱ
+} Persist_Lock_t;
+
+typedef struct
+{
+    Persist_Sys_t      sys;
+    Persist_Presence_t presence;
+    Persist_Light_t    light;
+    Persist_Servo_t    servo;
+    Persist_Ckpt_t     ckpt;
+    Persist_Visitor_t  visitor;
+    Persist_Lock_t     lock;
+} Persist_Data_t;
+
+/* ¼, Ĳ PersistData ͱһλ */
+#define PERSIST_REC_SYS        (1u << 0)
+#define PERSIST_REC_PRESENCE   (1u << 1)
+#define PERSIST_REC_LIGHT      (1u << 2)
+#define PERSIST_REC_SERVO      (1u << 3)
+#define PERSIST_REC_CKPT       (1u << 4)
+#define PERSIST_REC_VISITOR    (1u << 5)
+#define PERSIST_REC_LOCK       (1u << 6)
+#define PERSIST_REC_ALL        0x7Fu
+
+typedef struct
+{
+    uint32_t marks;           // Ǵ (һμһ), Ǳϵۼ (綨ʱλ)
+    uint32_t commits;         // ʵύ
+    uint32_t words;           // д뱸SRAM
+    uint32_t seq;             // ۼύ (縴λ)
+    uint32_t validate_us;     // Уʱ
+} Persist_Stats_t;
+
+/* RAM : ģֱӸԼǲ,  Persist_MarkDirty;  Persist_Flush д */
+extern Persist_Data_t PersistData;
+
+uint8_t Persist_Init(uint8_t is_hot_start);   // 1: ѻָЧ
+void Persist_MarkDirty(uint32_t recs);
+uint8_t Persist_Flush(void);                  // иĶύ, 1ʾд
+void Persist_Task(void);                      // ѭ, Ƶʱύ
+void Persist_GetStats(Persist_Stats_t *st);
+
+#endif /* __PERSIST_H */
@@ -0,0 +1,21 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PRESENCE_H
+#define __PRESENCE_H
+
+#include "stm32f4xx_hal.h"
+
+/* ¼ */
+typedef enum
+{
+    PRESENCE_EVT_NONE = 0,
+    PRESENCE_EVT_ARRIVED,    // 
+    PRESENCE_EVT_DEPARTED    // 뿪(ͨբ)
+} Presence_Event_t;
+
+void Presence_Init(uint8_t is_hot_start);    // ʼ(ʱָ)
+void Presence_Save(void);                    // λǰߵ
+void Presence_Update(uint16_t sample);       // ADCже, ÿO(1)
+Presence_Event_t Presence_GetEvent(void);    // ѭȡ¼
+uint8_t Presence_IsVehicle(void);            // ǰǷг
+
+#endif /* __PRESENCE_H */
@@ -0,0 +1,45 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PWD_HASH_H
+#define __PWD_HASH_H
+
+#include "stm32f4xx_hal.h"
+#include "sha256.h"
+
+#define PWD_LEN                 8       // Žλ
+#define PWD_SALT_LEN            16
+#define PWD_VERIFY_BUDGET_US    1000    // һУ (ժҪ) ʱ
+
+/* 1: ʱժҪȽϵʱ (ct_bench, DWT ʱ); 0: ر
+ * HSI 16MHz ÿÿʮԼ 10s, ڼճι */
+#define PWD_CT_BENCH_ENABLE     0
+#define PWD_CT_BENCH_SAMPLES    1000000
+
+/* ֻκ SHA-256( | 8 λ),  */
+typedef struct
+{
+    uint8_t salt[PWD_SALT_LEN];
+    uint8_t digest[SHA256_DIGEST_LEN];
+} Pwd_Hash_t;
+
+typedef enum
+{
+    PWD_LOAD_OK = 0,          // ժҪ
+    PWD_LOAD_MIGRATED,        // Ǿɰ, ѻժҪ
+    PWD_LOAD_FACTORY          // û, ó
+} Pwd_Load_t;
+
+typedef struct
+{
+    uint32_t count;           // У
+    uint32_t hash_us;         // һժҪʱ
+    uint32_t hash_max_us;
+    uint32_t over_budget;     //  PWD_VERIFY_BUDGET_US Ĵ
+} Pwd_Stats_t;
+
+Pwd_Load_t Pwd_Load(Pwd_Hash_t *h, const uint8_t *factory);       // KV_Init ֮
+uint8_t Pwd_Store(Pwd_Hash_t *h, const uint8_t *digits);          // , ժҪ, д Flash
+void Pwd_Digest(const Pwd_Hash_t *h, const uint8_t *digits, uint8_t *out);
+void Pwd_GetStats(Pwd_Stats_t *st);
+void Pwd_Ct_Bench(void);                                          // PWD_CT_BENCH_ENABLE
+
+#endif /* __PWD_HASH_H */
@@ -0,0 +1,62 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SERVO_H
+#define __SERVO_H
+
+#include "stm32f4xx_hal.h"
+
+/* 1: λջ (ADC3_IN6, PF8); 0: , ֱдȽֵ */
+#define SERVO_FEEDBACK_ENABLE   1
+
+#define SERVO_CLOSE  600    // բ (us)
+#define SERVO_OPEN   2400   // բ (us)
+
+/* һζĽ */
+typedef enum
+{
+    SERVO_EVT_NONE = 0,
+    SERVO_EVT_SETTLED,   // λȶ
+    SERVO_EVT_STALLED,   // ĿԶ
+    SERVO_EVT_TIMEOUT,   // 涨ʱûλ
+    SERVO_EVT_OBSTRUCTED // ⵽ת/, ѷͣס
+} Servo_Event_t;
+
+/* ˶״ */
+typedef enum
+{
+    SERVO_PROFILE_TRAPEZOID = 0,   // ٶ
+    SERVO_PROFILE_SCURVE           // S (ҼӼ, ٶ)
+} Servo_Shape_t;
+
+/* ˶߲, λ PWM (20ms) */
+typedef struct
+{
+    uint8_t shape;       // Servo_Shape_t
+    uint8_t max_vel;     // ٶ (us/)
+    uint8_t accel;       // ٶ (us/^2)
+} Servo_Profile_t;
+
+typedef struct
+{
+    uint16_t target;          // Ŀλ (us)
+    uint16_t position;        // λ (us)
+    uint16_t command;         // ʵȽֵ
+    uint16_t move_periods;    // ζõPWM
+    uint16_t profile_periods; // ˶߳ (PWM)
+    uint32_t isr_last_cycles; // жִʱ
+    uint32_t isr_max_cycles;  // ִʱ
+} Servo_Stats_t;
+
+void Servo_Init(uint8_t is_hot_start);
+void Servo_Save(void);                   // λǰֹͣ˶λ
+void Servo_Set(uint16_t pwm);            // 趨Ŀλ, ˶ƽȥ
+void Servo_SetProfile(const Servo_Profile_t *p);
+void Servo_GetProfile(Servo_Profile_t *p);
+void Servo_Feedback(uint16_t adc);       // ADCже
+void Servo_Ctrl_ISR(void);               // TIM12 же, ÿ20msһ
+void Servo_Obstruct_ISR(void);           // ⵽תʱ: բзբ, բо͵ͣס
+void Servo_Replan_ISR(void);             // PendSV е: ת滮
+int8_t Servo_Motion_Dir(void);           // ڶķ: 1 բ, -1 բ, 0 ֹ
+Servo_Event_t Servo_GetEvent(void);
+void Servo_GetStats(Servo_Stats_t *st);
+
+#endif /* __SERVO_H */
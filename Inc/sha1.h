@@ -0,0 +1,20 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SHA1_H
+#define __SHA1_H
+
+#include <stdint.h>
+
+/* ֻ HMAC-SHA1 (TOTP) : ÷Լƴ 64 ֽڿ,  16 ִ,
+ * ʡֽתͨõ Update/Final. չʽͬ sha256.h */
+#ifndef SHA1_UNROLL
+#if defined(__CC_ARM) || defined(__ARM_ARCH_7EM__)
+#define SHA1_UNROLL     1
+#else
+#define SHA1_UNROLL     0
+#endif
+#endif
+
+void Sha1_Init(uint32_t *state);                        // 5 
+void Sha1_Block(uint32_t *state, const uint32_t *w);    // ѹһ (16 )
+
+#endif /* __SHA1_H */
@@ -0,0 +1,31 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SHA256_H
+#define __SHA256_H
+
+#include <stdint.h>
+
+#define SHA256_BLOCK_LEN    64
+#define SHA256_DIGEST_LEN   32
+
+/* 1: ѹ 64 չ (Cortex-M4 ), 0: ѭ (, С).
+ * ֽȫһ. ˶ֵ: "abc" -> ba7816bf 8f01cfea ... f20015ad */
+#ifndef SHA256_UNROLL
+#if defined(__CC_ARM) || defined(__ARM_ARCH_7EM__)
+#define SHA256_UNROLL       1
+#else
+#define SHA256_UNROLL       0
+#endif
+#endif
+
+typedef struct
+{
+    uint32_t state[8];
+    uint32_t total;           // ֽ (< 512MB )
+    uint8_t  buf[SHA256_BLOCK_LEN];
+} Sha256_Ctx_t;
+
+void Sha256_Init(Sha256_Ctx_t *ctx);
+void Sha256_Update(Sha256_Ctx_t *ctx, const void *data, uint32_t len);
+void Sha256_Final(Sha256_Ctx_t *ctx, uint8_t *digest);
+
+#endif /* __SHA256_H */
@@ -53,7 +53,7 @@
 
 #define HAL_ADC_MODULE_ENABLED   
 //#define HAL_CAN_MODULE_ENABLED   
-//#define HAL_CRC_MODULE_ENABLED   
+#define HAL_CRC_MODULE_ENABLED   
 //#define HAL_CRYP_MODULE_ENABLED   
 //#define HAL_DAC_MODULE_ENABLED   
 //#define HAL_DCMI_MODULE_ENABLED   
@@ -69,7 +69,7 @@
 //#define HAL_I2S_MODULE_ENABLED   
 #define HAL_IWDG_MODULE_ENABLED   
 //#define HAL_LTDC_MODULE_ENABLED   
-//#define HAL_RNG_MODULE_ENABLED   
+#define HAL_RNG_MODULE_ENABLED   
 #define HAL_RTC_MODULE_ENABLED   
 //#define HAL_SAI_MODULE_ENABLED   
 //#define HAL_SD_MODULE_ENABLED   
@@ -79,7 +79,7 @@
 //#define HAL_USART_MODULE_ENABLED   
 //#define HAL_IRDA_MODULE_ENABLED   
 //#define HAL_SMARTCARD_MODULE_ENABLED   
-//#define HAL_WWDG_MODULE_ENABLED   
+#define HAL_WWDG_MODULE_ENABLED   
 //#define HAL_PCD_MODULE_ENABLED   
 //#define HAL_HCD_MODULE_ENABLED   
 //#define HAL_DSI_MODULE_ENABLED   
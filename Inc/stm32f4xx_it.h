@@ -45,8 +45,16 @@
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions ------------------------------------------------------- */
 
+void HardFault_Handler(void);
+void MemManage_Handler(void);
+void BusFault_Handler(void);
+void UsageFault_Handler(void);
+void PendSV_Handler(void);
 void SysTick_Handler(void);
 void EXTI15_10_IRQHandler(void);
+void TIM8_BRK_TIM12_IRQHandler(void);
+void DMA2_Stream0_IRQHandler(void);
+void HASH_RNG_IRQHandler(void);
 
 #ifdef __cplusplus
 }
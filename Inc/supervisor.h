@@ -0,0 +1,42 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SUPERVISOR_H
+#define __SUPERVISOR_H
+
+#include "stm32f4xx_hal.h"
+
+/* 1: ٿڿŹ WWDG, ι̫/̫λ; 0: ֻ IWDG.
+ * WWDG ֻܵ 524ms ( wwdg.h), Flash ʱ CPU ͣ 1~2s Ȼʱ,
+ * ֻڲ Flash  (־/ֵⲻ) µʱ */
+#define SUPERVISOR_WWDG_ENABLE   0
+
+/* ӵ, Լ Supervisor_Beat */
+typedef enum
+{
+    SUP_TASK_LOOP = 0,      // ѭ, ÿֽ
+    SUP_TASK_SERVO,         // TIM12 ж, 20ms
+    SUP_TASK_ADC,           // ADC3 ɨ DMA ж, Լ4kHz
+    SUP_TASK_NUM
+} Sup_Task_t;
+
+typedef struct
+{
+    uint32_t deadline;      //  (100us tick)
+    uint32_t max_age;       // ʱ
+    int32_t  min_slack;     // deadline - max_age, ʾ
+    uint32_t late;          // ʱ (ÿγʱֻһ)
+} Sup_Task_Stats_t;
+
+typedef struct
+{
+    uint32_t checks;        //  (ṹǱϵۼ, 綨ʱλ)
+    uint32_t held;          // ʱûιĴ
+    uint32_t wwdg_refresh;
+    Sup_Task_Stats_t task[SUP_TASK_NUM];
+} Sup_Stats_t;
+
+void Supervisor_Init(uint8_t is_hot_start);   // Ź֮
+void Supervisor_Beat(Sup_Task_t task);        // , жҲԵ
+void Supervisor_Check(void);                  // ѭ: ȫʱι
+void Supervisor_GetStats(Sup_Stats_t *st);
+
+#endif /* __SUPERVISOR_H */
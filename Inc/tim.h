@@ -45,12 +45,14 @@
 
 /* USER CODE END Includes */
 
+extern TIM_HandleTypeDef htim7;
 extern TIM_HandleTypeDef htim12;
 
 /* USER CODE BEGIN Private defines */
 
 /* USER CODE END Private defines */
 
+void MX_TIM7_Init(void);
 void MX_TIM12_Init(void);
 
 /* USER CODE BEGIN Prototypes */
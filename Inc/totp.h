@@ -0,0 +1,24 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __TOTP_H
+#define __TOTP_H
+
+#include <stdint.h>
+
+#define TOTP_STEP_S     30      // RFC 6238 Ĭϲ
+#define TOTP_WINDOW     1       // ǰ 1  (ʱ, )
+#define TOTP_KEY_MAX    64      // Կֽ (һ), ÿԿһ 20 ֽ
+
+/* һÿ͵ HMAC-SHA1 Կ, Ԥõм״̬, Կ */
+typedef struct
+{
+    uint32_t inner[5];          // ѹ (key ^ ipad) һ״̬
+    uint32_t outer[5];          // ѹ (key ^ opad) һ״̬
+    uint8_t  digits;            // 6~8 λ, 0: ո
+} Totp_Key_t;
+
+void Totp_Key_Init(Totp_Key_t *k, const uint8_t *secret, uint32_t len, uint8_t digits);
+uint32_t Totp_Hotp(const Totp_Key_t *k, uint32_t counter);     // RFC 4226,  32 λΪ 0
+uint32_t Totp_Input(const uint8_t *digits);                     // 8  (0~9) -> 
+int32_t Totp_Match(const Totp_Key_t *keys, uint32_t n, uint32_t step, uint32_t code, int8_t *drift);
+
+#endif /* __TOTP_H */
@@ -0,0 +1,44 @@
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __VISITOR_H
+#define __VISITOR_H
+
+#include "stm32f4xx_hal.h"
+#include "totp.h"
+
+#define VISITOR_MAX             8       // ÿ͸, ÿУȫһ
+#define VISITOR_SECRET_LEN      20      // HMAC-SHA1 Կ (RFC 4226 Ƽ 160 λ)
+#define VISITOR_TZ_OFFSET_S     (8 * 3600)   // RTC ߱ʱ (UTC+8),  TOTP õ UTC
+#define VISITOR_VERIFY_BUDGET_US 20000  //  8 λʱ, ÿĲ
+
+/* 1: ˶ RFC 6238 ӡ 1~VISITOR_MAX ÿ͵Уʱ (DWT); 0:  */
+#define VISITOR_BENCH_ENABLE    0
+
+/* ÿϢ, ڵڶ KV  (һԿǰ 16 ֽ) */
+typedef struct
+{
+    uint8_t  secret_tail[4];    // Կ 4 ֽ
+    uint16_t owner;             // ÿͱ
+    uint8_t  digits;            // 6~8 λ;  8 λʱǰ油 0
+    uint8_t  rule;              // ʱι (access_rule)
+    uint32_t expiry;            // ʱ (RTC_Now ), 0: 
+    uint32_t uses;              // ʹô
+} Visitor_Meta_t;
+
+typedef struct
+{
+    uint16_t count;             // ø
+    uint16_t replays;           // ùһ, ܵĴ
+    uint32_t verify_cycles;     // һУ
+    uint32_t verify_max_cycles;
+} Visitor_Stats_t;
+
+void Visitor_Init(void);                                        // KV_Init ֮
+int16_t Visitor_Verify(const uint8_t *digits, uint32_t now);    // 8 λ, ظ, -1: ͨ
+uint8_t Visitor_Get(uint16_t idx, Visitor_Meta_t *m);
+uint8_t Visitor_Set(uint16_t idx, const uint8_t *secret, const Visitor_Meta_t *m);
+uint8_t Visitor_Delete(uint16_t idx);
+void Visitor_Used(uint16_t idx);                                // ź: ², һ
+void Visitor_GetStats(Visitor_Stats_t *st);
+void Visitor_Bench(void);
+
+#endif /* __VISITOR_H */
@@ -1,16 +1,51 @@
 #include "RemoteInfrared.h"
 #include "stm32f4xx_hal.h"
+#include "ir_keymap.h"
+#include "ir_decode.h"
+#include "ir_capture.h"
+#include "dwt.h"
 
-#define REPEAT_KEY  0xEE
-#define IR_FILTER_MS 1000 //˲ʱֵ
+#define IR_QUEUE_MASK (IR_QUEUE_LEN - 1)
 
-extern __IO uint32_t GlobalTimingDelay100us;
-extern __IO uint32_t GlobalTimingDelay100usTx;
 
+/* жյ֡Ŷ, ѭһһȡ, ֻһ FlagGotKey า */
+typedef struct
+{
+    uint32_t tick;            // ֡ʱ (100us)
+    uint32_t raw;             // Remote_Infrared_data_union, ظΪ 0
+    uint8_t  repeat;          // 1: NEC ظ (9ms + 2.25ms)
+} IR_Raw_t;
+
+static IR_Raw_t ir_queue[IR_QUEUE_LEN];
+static __IO uint32_t ir_head = 0;          // жд
+static __IO uint32_t ir_tail = 0;          // ѭд
+static __IO uint32_t ir_edge_tick = 0;     // һ
+static IR_Stats_t ir_stats;
+
+// ŵļ: ظͳ (ir_decode.c)
+static IR_Hold_t held = { .key = IR_HOLD_NONE };
+
+static uint8_t LastRemoteID = 0;   // һЧңʶ
+
+typedef char ir_queue_check[(IR_QUEUE_LEN & IR_QUEUE_MASK) == 0 ? 1 : -1];
 
-__IO uint32_t FlagGotKey = 0;
 
-__IO Remote_Infrared_data_union RemoteInfrareddata;
+static void IR_Queue_Push(uint32_t raw, uint8_t repeat)
+{
+    uint32_t head = ir_head;
+    uint32_t depth = head - ir_tail;
+
+    if (depth >= IR_QUEUE_LEN)
+    {
+        ir_stats.overflow++;
+        return;
+    }
+    ir_queue[head & IR_QUEUE_MASK].tick = HAL_GetTick();
+    ir_queue[head & IR_QUEUE_MASK].raw = raw;
+    ir_queue[head & IR_QUEUE_MASK].repeat = repeat;
+    ir_head = head + 1;
+    if (depth + 1 > ir_stats.depth_max) ir_stats.depth_max = depth + 1;
+}
 
 
 /************************************************************************
@@ -23,192 +58,154 @@ __IO Remote_Infrared_data_union RemoteInfrareddata;
 ʾĴ,һֻ֤һ,ֶ,
 Ϊǳ¸ü.
 
-*: Remote_Infrared_KEY_ISR(INT11_vect )													 
-*: INT0жϷ		       									
-*: 					          									
-*: 		                           								
-*************************************************************************/	
-// Ϊ5ms
-const uint32_t TIME_DELAY_6MS = 60;
-const uint32_t TIME_DELAY_10MS = 100;
+*: Remote_Infrared_KEY_ISR
+*: PF15 ж, һصʱ佻 ir_decode.c 
+*: 
+*: 
+*  DWT ڼ (us), ٿ SysTick ݼ 100us ʱ.
+* ץʱԭһ (ir_capture.c).
+*************************************************************************/
 void Remote_Infrared_KEY_ISR(void)
 {
-	static __IO uint8_t  bBitCounter = 0; //֡λ
-  static __IO uint32_t bKeyCode = 0;
-	bBitCounter++;
+    static IR_Decoder_t dec;
+    static uint32_t last_cycles = 0;
+    uint32_t now = DWT_CYCCNT_GET();
+    uint32_t dt_us = DWT_Cycle_To_Us(now - last_cycles);
+    uint8_t level = Remote_Infrared_DAT_INPUT;
+    uint32_t code;
+
+    last_cycles = now;
+    ir_edge_tick = HAL_GetTick();
+    IR_Capture_Edge(level, dt_us);
+
+    switch (IR_Decode_Edge(&dec, level, dt_us, &code))
+    {
+        case IR_DEC_FRAME:
+            IR_Queue_Push(code, 0);
+            break;
+        case IR_DEC_REPEAT:
+            IR_Queue_Push(0, 1);       // ظ: ֵ, ѭʱ鵽ŵļ
+            break;
+        default:
+            break;
+    }
+}
 
-	if(bBitCounter == 1)        // ʼ9ms
-	{
-        if(Remote_Infrared_DAT_INPUT) // ߵƽЧ
-        {
-            bBitCounter = 0;
-        }
-        else
-        {
-            GlobalTimingDelay100us = TIME_DELAY_10MS;
-        }
-	}
-	else if(bBitCounter == 2)   // 4.5msĸ
-	{
-        if(Remote_Infrared_DAT_INPUT)
-        {
-            if((GlobalTimingDelay100us > 2) && (GlobalTimingDelay100us < 18))
-            {
-                GlobalTimingDelay100us = TIME_DELAY_6MS;
-            }
-            else
-            { 
-                bBitCounter = 0; 
-                printf(".");
-            }
-        }
+/************************************************************************
+*: Remote_Infrared_GetKey
+*: Ӷȡһ֡ɰ¼ (ѭ)
+*: ev ¼
+*: 1: ȡһ¼, 0: û
+*
+* ֡һ° (סңֻظ), ù̶˲.
+* ظһ֡/һظ벻 IR_REPEAT_GAP 㰴ס, 򶪵
+* ( orphan). Ӱס IR_LONG_TICKS һγ, ֮ظ.
+* Щж ir_decode.c (IR_Hold_xxx), ֻŶ, ͳ.
+* ʱõĶжʱ, ѭһȡӰж.
+************************************************************************/
+uint8_t Remote_Infrared_GetKey(IR_Key_Event_t *ev)
+{
+    while (ir_tail != ir_head)
+    {
+        IR_Raw_t r = ir_queue[ir_tail & IR_QUEUE_MASK];
+        uint16_t addr;
+        uint8_t proto, cmd, id, key, hold;
+        uint32_t code;
 
-        else
-        {
-            bBitCounter = 0;            
-        }
-	}
-	else if(bBitCounter == 3)   // 4.5msĸ
-	{
-        if(Remote_Infrared_DAT_INPUT)
-        {
-            bBitCounter = 0; 
-        }
-        else
-        {
-            if((GlobalTimingDelay100us > 5) && (GlobalTimingDelay100us < 20))
-            {
-                GlobalTimingDelay100us = TIME_DELAY_6MS;
-                printf("");
-            }
-            else if((GlobalTimingDelay100us > 32) && (GlobalTimingDelay100us < 46))
-            {
-                bBitCounter = 0;
-                RemoteInfrareddata.uiRemoteInfraredData = bKeyCode;
-                //RemoteInfrareddata.uiRemoteInfraredData = REPEAT_KEY;
-                bBitCounter = 0;
-                FlagGotKey = 1;
-            }            
-            else
-            {
-                bBitCounter = 0; 
-                //printf("%d&", GlobalTimingDelay100us);
-            }          
-        }
-	}    
-	else if(bBitCounter > 3 && bBitCounter < 68) //8λ
-	{  
+        ir_tail = ir_tail + 1;
 
-        if(Remote_Infrared_DAT_INPUT)
+        if (r.repeat)
         {
-            if((GlobalTimingDelay100us > 50) && (GlobalTimingDelay100us < 58))
+            hold = IR_Hold_Repeat(&held, r.tick);
+            if (hold == IR_HOLD_ORPHAN)
             {
-                GlobalTimingDelay100us = TIME_DELAY_6MS;
+                ir_stats.orphan++;
+                continue;
             }
-            else
-            {
-                bBitCounter = 0; 
-                //printf("#");
-            }           
-        }
-        else
-        {
-            if((GlobalTimingDelay100us > 50) && (GlobalTimingDelay100us < 58)) // '0'
+            ir_stats.repeats++;
+
+            ev->tick = r.tick;
+            ev->key = held.key;
+            ev->remote_id = held.id;
+            ev->type = IR_KEY_REPEAT;
+            if (hold == IR_HOLD_LONG)
             {
-                GlobalTimingDelay100us = TIME_DELAY_6MS;
-		        bKeyCode <<= 1;  // MSB First 
-                bKeyCode += 0x00;
+                ev->type = IR_KEY_LONG;
+                ir_stats.longs++;
             }
-            else if((GlobalTimingDelay100us > 40) && (GlobalTimingDelay100us < 48)) //'1'
-            {
-                GlobalTimingDelay100us = TIME_DELAY_6MS;            
-		        bKeyCode <<= 1;  // MSB First 
-                bKeyCode += 0x01;
-            }              
-            else
-            {
-			    //test = GlobalTimingDelay100us;
-                bBitCounter = 0; 
-                //printf("*%d", test);
-            }  
+            LastRemoteID = held.id;
+            return 1;
         }
 
-       if(bBitCounter == 67)
+        IR_Hold_Press(&held, IR_HOLD_NONE, 0, r.tick);
+
+        proto = IR_Decode_Split(r.raw, &addr, &cmd);
+        if (proto == 0)
         {
-            RemoteInfrareddata.uiRemoteInfraredData = bKeyCode;
-            bBitCounter = 0;
-            FlagGotKey = 1;
-            //printf("KeyCode = 0x%X", bKeyCode);
+            printf("\n\r IR DATA ERR");
+            ir_stats.errors++;
+            continue;
         }
-	}
-	else
-	{
-		bBitCounter = 0;
-        //printf("KeyCode = 0x%X", bKeyCode);
-	}
-}
+        code = KEYMAP_CODE(proto, addr, cmd);
+        id = (uint8_t)(r.raw >> 24);
 
-/************************************************************************
-*: unsigned char Remote_Infrared_KeyDeCode(unsigned char bKeyCode)					 
-*: PS2̽		       									    
-*: bKeyCode  							
-*: ASIIC		                           								
-************************************************************************/
-uint8_t Remote_Infrared_KeyDeCode(void)
-{
-    uint8_t ret = 0xFF;   // Ĭް
-	
-		static uint32_t last_key_tick = 0;
+        LastRemoteID = id;
+        ir_stats.frames++;
 
-    if (FlagGotKey == 1)
-    {
-        FlagGotKey = 0;
-
-				if ((HAL_GetTick() - last_key_tick) < IR_FILTER_MS)
+        // ѧϰ: ֻѧ, ״̬
+        if (Keymap_Learning())
         {
-            return 0xFF; // ֱӷް
+            Keymap_Learn_Feed(code);
+            continue;
         }
 
-        if ((RemoteInfrareddata.RemoteInfraredDataStruct.bID ==
-             (uint8_t)~RemoteInfrareddata.RemoteInfraredDataStruct.bIDNot)
-         && (RemoteInfrareddata.RemoteInfraredDataStruct.bKeyCode ==
-             (uint8_t)~RemoteInfrareddata.RemoteInfraredDataStruct.bKeyCodeNot))
-        {
-						last_key_tick = HAL_GetTick();
-            printf("\n\r IR KeyCode = 0x%02X, ",
-                   RemoteInfrareddata.RemoteInfraredDataStruct.bKeyCode);
-
-            switch (RemoteInfrareddata.RemoteInfraredDataStruct.bKeyCode)
-            {
-                case 0x08: ret = 1; printf("1"); break;
-                case 0x88: ret = 2; printf("2"); break;
-                case 0x48: ret = 3; printf("3"); break;
-                case 0xC8: ret = 4; printf("4"); break;
-                case 0x28: ret = 5; printf("5"); break;
-                case 0xA8: ret = 6; printf("6"); break;
-                case 0xE8: ret = 7; printf("7"); break;
-                case 0x18: ret = 8; printf("8"); break;
-                case 0x98: ret = 9; printf("9"); break;
-                case 0xB8: ret = 0; printf("0"); break;
-
-                case 0x78: ret = 0x78; printf("DEL"); break;
-
-                default:
-                    printf("Unknown");
-                    ret = 0xFF;
-                    break;
-            }
-        }
+        key = Keymap_Lookup(code);
+        printf("\n\r IR KeyCode = 0x%02X, addr 0x%04X, ", cmd, addr);
+        if (key == KEYMAP_KEY_DEL)
+            printf("DEL");
+        else if (key <= 9)
+            printf("%u", key);
         else
         {
-            printf("\n\r IR DATA ERR");
-            ret = 0xFF;
+            printf("Unknown");
+            ir_stats.unknown++;
+            continue;
         }
+
+        IR_Hold_Press(&held, key, id, r.tick);
+
+        ev->tick = r.tick;
+        ev->key = key;
+        ev->remote_id = id;
+        ev->type = IR_KEY_PRESS;
+        return 1;
     }
+    return 0;
+}
 
-    return ret;
+// ﻹûȡ, һ֡/ż: ʱλһ, ȻͶ
+uint8_t Remote_Infrared_Busy(void)
+{
+    return ir_tail != ir_head || HAL_GetTick() - ir_edge_tick < IR_REPEAT_GAP;
 }
 
+// һûļ, ظ뻹: ʱλ곤 ( IR_LONG_TICKS).
+// held ֻ RAM , λظҲǰһ֡, ס DEL վԶȲ
+uint8_t Remote_Infrared_Holding(void)
+{
+    return held.key != IR_HOLD_NONE && !held.long_sent &&
+           HAL_GetTick() - held.last_tick <= IR_REPEAT_GAP;
+}
 
+void Remote_Infrared_GetStats(IR_Stats_t *st)
+{
+    *st = ir_stats;
+    st->depth = (uint8_t)(ir_head - ir_tail);
+}
 
 
+// һЧĸң (ʶ), ƽⰴֿ
+uint8_t Remote_Infrared_LastID(void)
+{
+    return LastRemoteID;
+}
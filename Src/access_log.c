@@ -0,0 +1,373 @@
+#include "access_log.h"
+#include "stm32f4xx_hal.h"
+#include "persist.h"
+#include "crc.h"
+#include "rtc.h"
+#include "dwt.h"
+#include "usart.h"
+#include "string.h"
+#include "stdio.h"
+
+/************************************************************************
+* ־ (˭ʲôʱ򿪹բ)
+*
+* ÿ 16 ֽڶ¼, :
+*   1. ݴ: SRAM 1KB (BKPSRAM_LOG_ADDR), 63 . AccessLog_Append ֻ
+*      дһٰѼһ, O(1),  Flash. λ(200msһ).
+*   2. Flash : 8/9 (0x08080000 / 0x080A0000),  8192 . ݴ
+*      LOG_BATCH  AccessLog_Task һдȥ, ٱ̴.
+*      ǰдͲһд, ϵ 8192 .
+*
+* ʱ CPU ȡָͣ 1~2s, ֻ idle (բû) ʱ; ʱ
+* ¼ݴ, ݴ¼¼.
+*
+* Flash ûж: ڼ¼д, ÿֲ
+* һλ (13 ζ), ¼ seq Ⱥ. дһ븴λ
+* ʱ, ݴ seq  Flash һļ¼д.
+*
+* : յ ALOG_DUMP_CMD, ʴӡһʾ,  100ms 
+* е ALOG_DUMP_BAUD, Ȼ DMA ֱӴ Flash / SRAM 
+* ֡ͷ + ȫ¼ ( -> ǰ -> ݴ) ȥ,  CPU .
+* ڼѭճ, ֻ printf . ˽ Tools/alog_dump.c.
+*************************************************************************/
+
+#define LOG_SECTOR_SIZE       0x20000
+#define LOG_SECTOR_RECS       (LOG_SECTOR_SIZE / sizeof(AccessLog_Record_t))
+#define LOG_REC(n, i)         ((const AccessLog_Record_t *)(log_base[n] + (i) * sizeof(AccessLog_Record_t)))
+#define LOG_ERASED            0xFFFFFFFFu
+#define LOG_REC_WORDS         (sizeof(AccessLog_Record_t) / 4)
+#define LOG_STAGE_MAGIC       0x47545341u   // "ASTG"
+#define LOG_STAGE_NUM         63
+#define LOG_STAGE             ((Log_Stage_t *)BKPSRAM_LOG_ADDR)
+#define LOG_BATCH             16            // ܹôдһ Flash
+#define LOG_DUMP_CHUNK        0x8000        // һ DMA  65535
+#define LOG_DUMP_WAIT_TICKS   1000          // 100ms, в
+
+typedef struct
+{
+    uint32_t magic;
+    uint16_t first;           // [first, count) ǻûд Flash 
+    uint16_t count;
+    uint32_t reserved[2];
+    AccessLog_Record_t rec[LOG_STAGE_NUM];
+} Log_Stage_t;
+
+typedef char log_size_check[(sizeof(AccessLog_Record_t) == 16 &&
+                             sizeof(Log_Stage_t) <= 0x400) ? 1 : -1];
+
+typedef enum
+{
+    DUMP_IDLE = 0,
+    DUMP_WAIT,                // ʾѴӡ, в
+    DUMP_SEND,                // DMA 
+    DUMP_DRAIN                // һν˷ͼĴ, ȷ
+} Log_Dump_State_t;
+
+static const uint32_t log_base[2]   = { 0x08080000u, 0x080A0000u };
+static const uint32_t log_sector[2] = { FLASH_SECTOR_8, FLASH_SECTOR_9 };
+
+static uint8_t  log_cur = 0;          // ǰд
+static uint32_t log_wp = 0;           // ǰд
+static uint32_t log_old_cnt = 0;      // һ (0 д)
+static uint32_t log_next_seq = 1;
+static AccessLog_Stats_t log_stats;
+
+static uint8_t  log_dump_state = DUMP_IDLE;
+static uint32_t log_dump_tick = 0;
+static AccessLog_Dump_Head_t log_dump_head;
+static struct
+{
+    uint32_t addr;
+    uint32_t len;
+} log_dump_part[4];
+static uint8_t  log_dump_idx = 0;
+static uint32_t log_dump_off = 0;
+
+
+// RTC ǽʱ (), 縴λ/; ʱûù 0
+static uint32_t AccessLog_Now(void)
+{
+    return RTC_Now();
+}
+
+static uint8_t AccessLog_Rec_Valid(const AccessLog_Record_t *r)
+{
+    return r->crc == CRC_Calc32((const uint32_t *)r, LOG_REC_WORDS - 1);
+}
+
+// һλ (seq ֻǲ̬), ¼д, ּ
+static uint32_t AccessLog_Fill(uint8_t n)
+{
+    uint32_t lo = 0, hi = LOG_SECTOR_RECS;
+
+    while (lo < hi)
+    {
+        uint32_t mid = (lo + hi) / 2;
+        if (LOG_REC(n, mid)->seq == LOG_ERASED)
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    return lo;
+}
+
+static uint8_t AccessLog_Erase(uint8_t n)
+{
+    FLASH_EraseInitTypeDef erase;
+    uint32_t err = 0;
+    HAL_StatusTypeDef st;
+
+    erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+    erase.Sector = log_sector[n];
+    erase.NbSectors = 1;
+    erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+
+    IWDG->KR = IWDG_KEY_RELOAD;   // Ź 3s, һ 128KB  2s
+
+    HAL_FLASH_Unlock();
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR |
+                           FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR);
+    st = HAL_FLASHEx_Erase(&erase, &err);
+    HAL_FLASH_Lock();
+
+    IWDG->KR = IWDG_KEY_RELOAD;
+    log_stats.erases++;
+    return st == HAL_OK;
+}
+
+void AccessLog_Init(void)
+{
+    Log_Stage_t *st = LOG_STAGE;
+    uint32_t t0, fill0, fill1, last, n;
+
+    memset(&log_stats, 0, sizeof(log_stats));
+    log_dump_state = DUMP_IDLE;
+
+    t0 = DWT_CYCCNT_GET();
+    fill0 = AccessLog_Fill(0);
+    fill1 = AccessLog_Fill(1);
+
+    if (fill0 && fill1)
+        log_cur = ((int32_t)(LOG_REC(1, 0)->seq - LOG_REC(0, 0)->seq) > 0) ? 1 : 0;
+    else
+        log_cur = fill1 ? 1 : 0;
+    log_wp      = log_cur ? fill1 : fill0;
+    log_old_cnt = log_cur ? fill0 : fill1;
+    last = log_wp ? LOG_REC(log_cur, log_wp - 1)->seq : 0;
+
+    // ݴ: SRAM ߵһþ
+    if (st->magic != LOG_STAGE_MAGIC || st->count > LOG_STAGE_NUM || st->first > st->count)
+    {
+        st->magic = LOG_STAGE_MAGIC;
+        st->first = 0;
+        st->count = 0;
+    }
+
+    // дһ븴λβͲҪ; Ѿ Flash 
+    n = st->first;
+    while (n < st->count && AccessLog_Rec_Valid(&st->rec[n])) n++;
+    st->count = n;
+    n = st->first;
+    while (n < st->count && (int32_t)(st->rec[n].seq - last) <= 0) n++;
+    st->first = n;
+
+    log_next_seq = ((st->count > st->first) ? st->rec[st->count - 1].seq : last) + 1;
+    log_stats.init_us = DWT_Cycle_To_Us(DWT_CYCCNT_GET() - t0);
+}
+
+/**
+  * @brief ׷һ, ֻдSRAM. д¼ټӼ, дһ븴λ
+  */
+void AccessLog_Append(uint8_t event, uint8_t keys, uint8_t outcome, uint8_t state)
+{
+    Log_Stage_t *st = LOG_STAGE;
+    AccessLog_Record_t *r;
+
+    if (st->count >= LOG_STAGE_NUM)
+    {
+        log_stats.dropped++;
+        return;
+    }
+
+    r = &st->rec[st->count];
+    r->seq     = log_next_seq;
+    r->time    = AccessLog_Now();
+    r->event   = event;
+    r->keys    = keys;
+    r->outcome = outcome;
+    r->state   = state;
+    r->crc     = CRC_Calc32((const uint32_t *)r, LOG_REC_WORDS - 1);
+    __DSB();
+
+    st->count++;
+    log_next_seq++;
+}
+
+/**
+  * @brief ݴд Flash. ÿдһǰ first, ;λظд
+  */
+static void AccessLog_Flush(uint8_t idle)
+{
+    Log_Stage_t *st = LOG_STAGE;
+
+    while (st->first < st->count)
+    {
+        const uint32_t *w = (const uint32_t *)&st->rec[st->first];
+        uint32_t addr;
+
+        if (log_wp >= LOG_SECTOR_RECS)
+        {
+            if (!idle) break;                       // Ҫͣ 1~2s, ȿ˵
+            if (!AccessLog_Erase(!log_cur)) break;
+            log_cur = !log_cur;
+            log_old_cnt = LOG_SECTOR_RECS;
+            log_wp = 0;
+        }
+
+        addr = (uint32_t)LOG_REC(log_cur, log_wp);
+        HAL_FLASH_Unlock();
+        __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR |
+                               FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR);
+        for (uint32_t i = 0; i < LOG_REC_WORDS; i++)
+        {
+            HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, addr + i * 4, w[i]);
+        }
+        HAL_FLASH_Lock();
+
+        log_wp++;   // дҲռλ, ʱ CRC Ծ
+        st->first++;
+    }
+
+    if (st->first >= st->count)
+    {
+        st->count = 0;
+        st->first = 0;
+    }
+    log_stats.flushes++;
+}
+
+// һ, û˷0
+static uint8_t AccessLog_Dump_Next(void)
+{
+    DMA_HandleTypeDef *hdma = huart1.hdmatx;
+    uint32_t len;
+
+    while (log_dump_idx < 4 && log_dump_off >= log_dump_part[log_dump_idx].len)
+    {
+        log_dump_idx++;
+        log_dump_off = 0;
+    }
+    if (log_dump_idx >= 4) return 0;
+
+    len = log_dump_part[log_dump_idx].len - log_dump_off;
+    if (len > LOG_DUMP_CHUNK) len = LOG_DUMP_CHUNK;
+
+    // һδԼ, ,  Abort 
+    HAL_DMA_Abort(hdma);
+    __HAL_DMA_CLEAR_FLAG(hdma, __HAL_DMA_GET_TC_FLAG_INDEX(hdma) | __HAL_DMA_GET_HT_FLAG_INDEX(hdma) |
+                               __HAL_DMA_GET_TE_FLAG_INDEX(hdma) | __HAL_DMA_GET_FE_FLAG_INDEX(hdma) |
+                               __HAL_DMA_GET_DME_FLAG_INDEX(hdma));
+    HAL_DMA_Start(hdma, log_dump_part[log_dump_idx].addr + log_dump_off,
+                  (uint32_t)&huart1.Instance->DR, len);
+    SET_BIT(huart1.Instance->CR3, USART_CR3_DMAT);
+
+    log_dump_off += len;
+    return 1;
+}
+
+static void AccessLog_Dump_Poll(void)
+{
+    switch (log_dump_state)
+    {
+        case DUMP_WAIT:
+            if (HAL_GetTick() - log_dump_tick < LOG_DUMP_WAIT_TICKS) break;
+            if (!__HAL_UART_GET_FLAG(&huart1, UART_FLAG_TC)) break;
+
+            huart1.Instance->BRR = UART_BRR_SAMPLING16(HAL_RCC_GetPCLK2Freq(), ALOG_DUMP_BAUD);
+            __HAL_UART_CLEAR_FLAG(&huart1, UART_FLAG_TC);
+            log_dump_idx = 0;
+            log_dump_off = 0;
+            AccessLog_Dump_Next();
+            log_dump_state = DUMP_SEND;
+            break;
+
+        case DUMP_SEND:
+            if (huart1.hdmatx->Instance->CR & DMA_SxCR_EN) break;
+            if (!AccessLog_Dump_Next()) log_dump_state = DUMP_DRAIN;
+            break;
+
+        case DUMP_DRAIN:
+            if (!__HAL_UART_GET_FLAG(&huart1, UART_FLAG_TC)) break;
+
+            CLEAR_BIT(huart1.Instance->CR3, USART_CR3_DMAT);
+            HAL_DMA_Abort(huart1.hdmatx);
+            huart1.Instance->BRR = UART_BRR_SAMPLING16(HAL_RCC_GetPCLK2Freq(), huart1.Init.BaudRate);
+            log_dump_state = DUMP_IDLE;
+            printf("\r\n [Log] Dump done, %u records.", log_dump_head.count);
+            break;
+
+        default:
+            log_dump_state = DUMP_IDLE;
+            break;
+    }
+}
+
+void AccessLog_Task(uint8_t idle)
+{
+    Log_Stage_t *st = LOG_STAGE;
+
+    if (log_dump_state != DUMP_IDLE)
+    {
+        AccessLog_Dump_Poll();   // ڼ䲻 Flash ݴ±
+        return;
+    }
+
+    if (st->count - st->first >= LOG_BATCH)
+    {
+        AccessLog_Flush(idle);
+    }
+}
+
+uint8_t AccessLog_Dump_Start(void)
+{
+    Log_Stage_t *st = LOG_STAGE;
+    uint32_t bytes = 0;
+
+    if (log_dump_state != DUMP_IDLE) return 0;
+
+    //  -> ǰ -> ݴ, ʱ˳
+    log_dump_part[0].addr = (uint32_t)&log_dump_head;
+    log_dump_part[0].len  = sizeof(log_dump_head);
+    log_dump_part[1].addr = log_base[!log_cur];
+    log_dump_part[1].len  = log_old_cnt * sizeof(AccessLog_Record_t);
+    log_dump_part[2].addr = log_base[log_cur];
+    log_dump_part[2].len  = log_wp * sizeof(AccessLog_Record_t);
+    log_dump_part[3].addr = (uint32_t)&st->rec[st->first];
+    log_dump_part[3].len  = (st->count - st->first) * sizeof(AccessLog_Record_t);
+    for (int i = 1; i < 4; i++) bytes += log_dump_part[i].len;
+
+    log_dump_head.magic    = ALOG_DUMP_MAGIC;
+    log_dump_head.version  = ALOG_DUMP_VERSION;
+    log_dump_head.rec_size = sizeof(AccessLog_Record_t);
+    log_dump_head.count    = bytes / sizeof(AccessLog_Record_t);
+    log_dump_head.crc      = CRC_Calc32((const uint32_t *)&log_dump_head, 3);
+
+    printf("\r\n [Log] Dump %u records at %u baud\r\n", log_dump_head.count, ALOG_DUMP_BAUD);
+
+    log_dump_tick = HAL_GetTick();
+    log_dump_state = DUMP_WAIT;
+    return 1;
+}
+
+uint8_t AccessLog_Dumping(void)
+{
+    return log_dump_state != DUMP_IDLE;
+}
+
+void AccessLog_GetStats(AccessLog_Stats_t *st)
+{
+    *st = log_stats;
+    st->next_seq = log_next_seq;
+    st->stored = log_old_cnt + log_wp;
+    st->staged = LOG_STAGE->count - LOG_STAGE->first;
+}
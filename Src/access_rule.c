@@ -0,0 +1,93 @@
+#include "access_rule.h"
+#include "kv_store.h"
+#include "rtc.h"
+#include "string.h"
+
+/************************************************************************
+* ʱι: ÿһ  x Сʱ λͼ (7 x 24 = 168 λ, 6 )
+*
+* Ǽʱ (ļ, 㵽),  Flash ֵ
+* KV_KEY_RULE_BASE +  . ޸ʱչλͼ, жϵʱֻ
+* ȡǰ/Сʱ, һλŲһα, ٱʱ.
+* ûдĬȫʱ.
+*************************************************************************/
+
+#define RULE_SLOTS   (7 * 24)
+#define RULE_WORDS   ((RULE_SLOTS + 31) / 32)
+
+static uint32_t rule_map[RULE_CODE_MAX][RULE_WORDS];
+
+
+static void Rule_Mark(uint32_t *map, uint8_t day, uint8_t hour)
+{
+    uint32_t bit = (uint32_t)day * 24 + hour;
+    map[bit >> 5] |= 1u << (bit & 31);
+}
+
+// ʱչλͼ
+static void Rule_Compile(uint32_t *map, const Rule_Window_t *win, uint8_t n)
+{
+    memset(map, 0, RULE_WORDS * 4);
+
+    if (n == 0)
+    {
+        memset(map, 0xFF, RULE_WORDS * 4);
+        return;
+    }
+
+    for (uint8_t i = 0; i < n; i++)
+    {
+        uint8_t start = win[i].start % 24;
+        uint8_t len = (win[i].end % 24 + 24 - start) % 24;   // Сʱ, 0 ȫ
+        if (len == 0) len = 24;
+
+        for (uint8_t d = 0; d < 7; d++)
+        {
+            if (!(win[i].days & (1u << d))) continue;
+
+            for (uint8_t h = 0; h < len; h++)
+            {
+                uint8_t hh = start + h;
+                Rule_Mark(map, (hh < 24) ? d : (d + 1) % 7, hh % 24);   // ҹ㵽ڶ
+            }
+        }
+    }
+}
+
+void Rule_Init(void)
+{
+    Rule_Window_t win[RULE_WINDOW_MAX];
+
+    for (uint8_t code = 0; code < RULE_CODE_MAX; code++)
+    {
+        uint8_t len = KV_Get(KV_KEY_RULE_BASE + code, win, sizeof(win));
+        Rule_Compile(rule_map[code], win, len / sizeof(Rule_Window_t));
+    }
+}
+
+uint8_t Rule_Set(uint8_t code, const Rule_Window_t *win, uint8_t n)
+{
+    if (code >= RULE_CODE_MAX || n > RULE_WINDOW_MAX) return 0;
+
+    Rule_Compile(rule_map[code], win, n);
+    if (n == 0) return KV_Delete(KV_KEY_RULE_BASE + code);
+    return KV_Set(KV_KEY_RULE_BASE + code, win, n * sizeof(Rule_Window_t));
+}
+
+uint8_t Rule_Allowed(uint8_t code, uint8_t weekday, uint8_t hour)
+{
+    uint32_t bit;
+
+    if (code >= RULE_CODE_MAX || weekday < 1 || weekday > 7 || hour > 23) return 0;
+
+    bit = (uint32_t)(weekday - 1) * 24 + hour;
+    return (rule_map[code][bit >> 5] >> (bit & 31)) & 1u;
+}
+
+uint8_t Rule_Check(uint8_t code)
+{
+    RTC_Calendar_t now;
+
+    if (!RTC_Calendar_Get(&now)) return RULE_UNSET_CLOCK_ALLOW;
+    return Rule_Allowed(code, now.weekday, now.hour);
+}
@@ -0,0 +1,109 @@
+#include "boot_prof.h"
+#include "persist.h"
+#include "crc.h"
+#include "dwt.h"
+#include "stdio.h"
+#include "string.h"
+
+/************************************************************************
+* ʱ
+*
+* main() ÿʼʱ BootProf_Mark һ DWT  (ֻд
+* RAM, Լʮ), һѭ֮ BootProf_Finish ΢
+* SRAM. вӡ (һ printf Ҫϰ΢, Ҫʱ
+* ), ´ (򴮿 'B') ʱ BootProf_Report ٰһεĽ
+* Ӵڴ; ̫Ƶ, һ BootProf_Summary.
+*
+* main() ֮ǰʱ (λ, SystemInit, ɢ) DWT , ֻд
+* ʱλʱ, øλǰµ CYCCNT ,  pre_main_us.
+*************************************************************************/
+
+#define BOOT_PROF_MAGIC   0x544F4F42u   // "BOOT"
+#define BOOT_PROF_REC     ((Boot_Prof_t *)BKPSRAM_BOOT_ADDR)
+
+typedef char boot_prof_size_check[(sizeof(Boot_Prof_t) % 4 == 0 && sizeof(Boot_Prof_t) <= 0x100) ? 1 : -1];
+
+static const char * const boot_stage_name[BOOT_STAGE_NUM] =
+{
+    "clock", "output", "dma", "tim12", "i2c1", "usart1", "tim7", "adc3",
+    "rng", "kv", "rtc", "rule", "restore", "servo", "sense", "log", "iwdg",
+    "loop", "defer"
+};
+
+static uint32_t boot_cycles[BOOT_STAGE_NUM];
+static Boot_Prof_t boot_last;
+static uint8_t boot_last_valid = 0;
+
+
+static uint32_t BootProf_Crc(const Boot_Prof_t *p)
+{
+    return CRC_Calc32((const uint32_t *)p, (sizeof(Boot_Prof_t) - 4) / 4);
+}
+
+void BootProf_Mark(Boot_Stage_t stage)
+{
+    if (stage < BOOT_STAGE_NUM) boot_cycles[stage] = DWT_CYCCNT_GET();
+}
+
+/**
+  * @brief ȰѱSRAMһεļ¼, д뱾ε. SRAM
+  * Persist_Init ; ʱݲ,  magic  CRC ж
+  */
+void BootProf_Finish(uint8_t hot, uint8_t resumed, uint32_t pre_main_us)
+{
+    Boot_Prof_t *rec = BOOT_PROF_REC;
+
+    boot_last_valid = (rec->magic == BOOT_PROF_MAGIC && rec->crc == BootProf_Crc(rec));
+    if (boot_last_valid) boot_last = *rec;
+
+    rec->magic = 0;   // дһ븴λ
+    rec->boots = boot_last_valid ? boot_last.boots + 1 : 1;
+    rec->hot = hot;
+    rec->resumed = resumed;
+    rec->reserved = 0;
+    rec->pre_main_us = pre_main_us;
+    for (int i = 0; i < BOOT_STAGE_NUM; i++)
+    {
+        rec->stamp_us[i] = DWT_Cycle_To_Us(boot_cycles[i]);
+    }
+    rec->magic = BOOT_PROF_MAGIC;
+    rec->crc = BootProf_Crc(rec);
+}
+
+uint8_t BootProf_GetLast(Boot_Prof_t *prof)
+{
+    if (boot_last_valid) *prof = boot_last;
+    return boot_last_valid;
+}
+
+/**
+  * @brief ֻһ: һ(һѭ)ʱ
+  */
+void BootProf_Summary(void)
+{
+    if (!boot_last_valid) return;
+
+    printf("\n\r [Boot] #%u %s start: IR ready %u us after main()",
+           boot_last.boots, boot_last.resumed ? "resumed" : (boot_last.hot ? "hot" : "cold"),
+           boot_last.stamp_us[BOOT_STAGE_LOOP]);
+    if (boot_last.pre_main_us)
+        printf(", %u us before main()", boot_last.pre_main_us);
+}
+
+/**
+  * @brief ÿ׶δӡ׶κʱ
+  */
+void BootProf_Report(void)
+{
+    uint32_t prev = 0;
+
+    if (!boot_last_valid) return;
+
+    BootProf_Summary();
+    for (int i = 0; i < BOOT_STAGE_NUM; i++)
+    {
+        if (i % 6 == 0) printf("\n\r       ");
+        printf(" %s %u", boot_stage_name[i], boot_last.stamp_us[i] - prev);
+        prev = boot_last.stamp_us[i];
+    }
+}
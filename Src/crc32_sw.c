@@ -0,0 +1,25 @@
+#include "crc32_sw.h"
+
+/************************************************************************
+* CRC-32/MPEG-2 İְ汾,  STM32F4 CRC Ԫȫͬ:
+* ʽ 0x04C11DB7, ֵ 0xFFFFFFFF, 32λִ (ڸλȽ),
+* ת, ޽.
+*
+* ע""ֽ: С˻ϰֽı׼ CRC-32 һ.
+* ̼Ӳ, ֻ˺û CRC Ԫĳ, ׷ٶ.
+*************************************************************************/
+
+uint32_t Crc32_Sw(const uint32_t *buf, uint32_t words)
+{
+    uint32_t crc = 0xFFFFFFFFu;
+
+    while (words--)
+    {
+        crc ^= *buf++;
+        for (int i = 0; i < 32; i++)
+        {
+            crc = (crc & 0x80000000u) ? (crc << 1) ^ 0x04C11DB7u : (crc << 1);
+        }
+    }
+    return crc;
+}
@@ -0,0 +1,58 @@
+#include "cred_match.h"
+
+/************************************************************************
+* ûƥ (ʱ)
+*
+* ܱмЧ, Ҳеǵڼ,  n ͷβһ,
+* ÿͬ, ûݵķ֧, Ҳûǰ˳: ȽϽȫ1/
+* ȫ0 ʾ, /ϲ. Ӱʱ䲻й¶ڱ
+* λ, Ҳй¶ж.
+*
+* ж:  &&  && ( || (ʱ && now < expiry)).
+* ʱûʱ޵һɲͨ.
+*
+* ֻ stdint, Ͽֱӱ (Tools/cred_bench.c).
+*************************************************************************/
+
+// x == 0 ʱȫ1, ȫ0
+static uint32_t Cred_Mask_Zero(uint32_t x)
+{
+    return ((x | (0u - x)) >> 31) - 1u;
+}
+
+// a < b (޷) ʱȫ1, ȫ0
+static uint32_t Cred_Mask_Less(uint32_t a, uint32_t b)
+{
+    uint32_t borrow = ((~a & b) | (~(a ^ b) & (a - b))) >> 31;
+    return 0u - borrow;
+}
+
+uint32_t Cred_Pack(const uint8_t *digits)
+{
+    uint32_t code = 0;
+
+    for (int i = 0; i < 8; i++)
+    {
+        code = (code << 4) | (digits[i] & 0x0F);
+    }
+    return code;
+}
+
+int32_t Cred_Match(const Cred_Entry_t *tab, uint32_t n, uint32_t code, uint32_t now)
+{
+    uint32_t found = 0, index = 0;
+    uint32_t clock_set = ~Cred_Mask_Zero(now);
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint32_t eq   = Cred_Mask_Zero(tab[i].code ^ code);
+        uint32_t on   = 0u - (uint32_t)(tab[i].flags & CRED_FLAG_ENABLED);
+        uint32_t live = Cred_Mask_Zero(tab[i].expiry) |
+                        (clock_set & Cred_Mask_Less(now, tab[i].expiry));
+        uint32_t hit  = eq & on & live & ~found;   // ظȡһ
+
+        index |= hit & i;
+        found |= hit;
+    }
+    return (int32_t)(index | ~found);
+}
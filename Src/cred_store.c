@@ -0,0 +1,139 @@
+#include "cred_store.h"
+#include "kv_store.h"
+#include "dwt.h"
+#include "string.h"
+#include "stdio.h"
+
+/************************************************************************
+* û
+*
+* ԭȫ, , ݹһ. ڳԭ (sysData.pwd,
+* ʱι 0 ) ,  CRED_MAX û, ÿû, ñ־,
+* ʱ, ʱιźʹô (Cred_Entry_t, 16 ֽ).
+*
+* ÿɼֵһ (KV_KEY_CRED_BASE + ),  RAM ı.
+* ֤ʱ Cred_Match ű (CRED_MAX , ø) ɨһ,
+* ʱһ, м޹. 256 ʵ verify_cycles.
+*
+* ʹôÿοżһдؼֵ (׷һ 24 ֽڼ¼), һ켸ʮ,
+* һúܾ, д˼ֵԼ.
+*************************************************************************/
+
+static Cred_Entry_t cred_table[CRED_MAX];
+static Cred_Stats_t cred_stats;
+
+
+void Cred_Init(void)
+{
+    memset(cred_table, 0, sizeof(cred_table));
+    memset(&cred_stats, 0, sizeof(cred_stats));
+
+    for (int i = 0; i < CRED_MAX; i++)
+    {
+        if (KV_Get(KV_KEY_CRED_BASE + i, &cred_table[i], sizeof(Cred_Entry_t)) == sizeof(Cred_Entry_t))
+        {
+            cred_stats.count++;
+        }
+        else
+        {
+            memset(&cred_table[i], 0, sizeof(Cred_Entry_t));
+        }
+    }
+}
+
+int16_t Cred_Verify(const uint8_t *digits, uint32_t now)
+{
+    uint32_t t0 = DWT_CYCCNT_GET();
+    int32_t idx = Cred_Match(cred_table, CRED_MAX, Cred_Pack(digits), now);
+
+    cred_stats.verify_cycles = DWT_CYCCNT_GET() - t0;
+    if (cred_stats.verify_cycles > cred_stats.verify_max_cycles)
+        cred_stats.verify_max_cycles = cred_stats.verify_cycles;
+    return (int16_t)idx;
+}
+
+uint8_t Cred_Get(uint16_t idx, Cred_Entry_t *e)
+{
+    if (idx >= CRED_MAX || !(cred_table[idx].flags & CRED_FLAG_ENABLED)) return 0;
+
+    *e = cred_table[idx];
+    return 1;
+}
+
+uint8_t Cred_Set(uint16_t idx, const Cred_Entry_t *e)
+{
+    if (idx >= CRED_MAX) return 0;
+    if (!KV_Set(KV_KEY_CRED_BASE + idx, e, sizeof(Cred_Entry_t))) return 0;
+
+    if (!(cred_table[idx].flags & CRED_FLAG_ENABLED) && (e->flags & CRED_FLAG_ENABLED)) cred_stats.count++;
+    if ((cred_table[idx].flags & CRED_FLAG_ENABLED) && !(e->flags & CRED_FLAG_ENABLED)) cred_stats.count--;
+    cred_table[idx] = *e;
+    return 1;
+}
+
+uint8_t Cred_Delete(uint16_t idx)
+{
+    if (idx >= CRED_MAX) return 0;
+    if (!KV_Delete(KV_KEY_CRED_BASE + idx)) return 0;
+
+    if (cred_table[idx].flags & CRED_FLAG_ENABLED) cred_stats.count--;
+    memset(&cred_table[idx], 0, sizeof(Cred_Entry_t));
+    return 1;
+}
+
+void Cred_Used(uint16_t idx)
+{
+    if (idx >= CRED_MAX) return;
+
+    cred_table[idx].uses++;
+    KV_Set(KV_KEY_CRED_BASE + idx, &cred_table[idx], sizeof(Cred_Entry_t));
+}
+
+void Cred_GetStats(Cred_Stats_t *st)
+{
+    *st = cred_stats;
+}
+
+#if CRED_BENCH_ENABLE
+static Cred_Entry_t cred_bench_tab[1000];
+
+static uint32_t Cred_Bench_One(uint32_t n, uint32_t code)
+{
+    uint32_t t0 = DWT_CYCCNT_GET();
+    volatile int32_t idx = Cred_Match(cred_bench_tab, n, code, 1);
+    (void)idx;
+    return DWT_CYCCNT_GET() - t0;
+}
+#endif
+
+/**
+  * @brief 10/100/1000 , ֱеһ, һ, е.
+  * Ӧһ (ڵˮ/ȡָ)
+  */
+void Cred_Bench(void)
+{
+#if CRED_BENCH_ENABLE
+    static const uint32_t sizes[3] = { 10, 100, 1000 };
+    uint32_t seed = 0x2545F491u;
+
+    for (int i = 0; i < 1000; i++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        cred_bench_tab[i].code = seed & 0x77777777u;   // ÿλ 0~7,  0x99999999 ײ
+        cred_bench_tab[i].owner = i;
+        cred_bench_tab[i].flags = CRED_FLAG_ENABLED;
+        cred_bench_tab[i].expiry = 0;
+    }
+
+    for (int k = 0; k < 3; k++)
+    {
+        uint32_t n = sizes[k];
+        uint32_t first = Cred_Bench_One(n, cred_bench_tab[0].code);
+        uint32_t last  = Cred_Bench_One(n, cred_bench_tab[n - 1].code);
+        uint32_t none  = Cred_Bench_One(n, 0x99999999u);
+
+        printf("\r\n [Cred] bench %4u entries: first %u, last %u, none %u cycles (%u us)",
+               n, first, last, none, DWT_Cycle_To_Us(none));
+    }
+#endif
+}
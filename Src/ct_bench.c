@@ -0,0 +1,152 @@
+#include "ct_bench.h"
+#include <math.h>
+#include <string.h>
+
+/************************************************************************
+* ʱȽϵʱ (dudect )
+*
+* ȡǰ׺ƥ䳤 L (0 ~ len), ǰ L ֽںֵͬ,  L ֽ
+* һͬ,  (L = len ȫ). һһ
+* (CT_BATCH), ʱ, ֻѱ⺯һεüȡʱ֮. ÿ L һ, ֵ//С/.
+*
+* Ȼÿһ L = 0  Welch t , |t|  CT_T_THRESHOLD ˵
+* ʱ"˼λ"й, ǲŵ. Ct_Compare_Early (ֽڱȽ, ͬ
+* ˳) Ƿ, Ҫǲⲻ˵Ա.
+*
+* Ⱥֵ:  CT_WARMUP , ȡ 99% λ 1.5 , ֮󳬹Ķ
+* (ж, ϵĵȺͻ). ֻռһ, Ŀ dropped.
+*
+* ֻ stdint/math/string:  Tools/ct_bench.c , ʱӻ
+* DWT (PWD_CT_BENCH_ENABLE). ͳ double, M4 , ڼʱΧ.
+*************************************************************************/
+
+#define CT_BATCH   64          // һ (2KB, ̬)
+
+static uint32_t ct_warm[CT_WARMUP];
+static uint8_t  ct_in[CT_BATCH][CT_LEN_MAX];
+static uint8_t  ct_len[CT_BATCH];
+static volatile uint8_t ct_sink;
+
+static uint32_t Ct_Rand(uint32_t *s)
+{
+    uint32_t x = *s;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *s = x;
+}
+
+static void Ct_Acc_Add(Ct_Acc_t *acc, uint32_t v)
+{
+    double d;
+
+    if (acc->n == 0 || v < acc->min) acc->min = v;
+    if (v > acc->max) acc->max = v;
+    acc->n++;
+    d = v - acc->mean;
+    acc->mean += d / acc->n;
+    acc->m2 += d * (v - acc->mean);
+}
+
+double Ct_Welch_T(const Ct_Acc_t *a, const Ct_Acc_t *b)
+{
+    double va, vb, den;
+
+    if (a->n < 2 || b->n < 2) return 0;
+
+    va = a->m2 / (a->n - 1);
+    vb = b->m2 / (b->n - 1);
+    den = sqrt(va / a->n + vb / b->n);
+    if (den == 0) return (a->mean == b->mean) ? 0 : 1e9;   // 鶼һ㲻
+    return (a->mean - b->mean) / den;
+}
+
+uint8_t Ct_Compare_Early(const uint8_t *a, const uint8_t *b, uint32_t n)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        if (a[i] != b[i]) return 0;
+    }
+    return 1;
+}
+
+// Ȱһ붼ʱ, ķ֧ͷô治ʱ
+static void Ct_Make_Batch(const uint8_t *secret, uint32_t len, uint32_t *seed)
+{
+    for (uint32_t k = 0; k < CT_BATCH; k++)
+    {
+        uint32_t l = Ct_Rand(seed) % (len + 1);
+        uint8_t *in = ct_in[k];
+
+        ct_len[k] = (uint8_t)l;
+        for (uint32_t i = 0; i < len; i++)
+        {
+            if (i < l)
+                in[i] = secret[i];
+            else if (i == l)
+                in[i] = secret[i] ^ (uint8_t)(Ct_Rand(seed) % 255 + 1);
+            else
+                in[i] = (uint8_t)Ct_Rand(seed);
+        }
+    }
+}
+
+static uint32_t Ct_Measure(Ct_Fn_t fn, const uint8_t *in, const uint8_t *secret, uint32_t len, Ct_Clock_t clock)
+{
+    uint32_t t0 = clock();
+    ct_sink = fn(in, secret, len);
+    return clock() - t0;
+}
+
+void Ct_Bench_Run(Ct_Result_t *res, Ct_Fn_t fn, uint32_t len, uint32_t samples,
+                  Ct_Clock_t clock, uint32_t seed, void (*yield)(void))
+{
+    uint8_t secret[CT_LEN_MAX];
+    uint32_t i, j, k, v;
+
+    if (len > CT_LEN_MAX) len = CT_LEN_MAX;
+    if (seed == 0) seed = 0x9E3779B9u;
+    memset(res, 0, sizeof(*res));
+    res->len = len;
+
+    for (i = 0; i < len; i++) secret[i] = (uint8_t)Ct_Rand(&seed);
+
+    // Ԥ: ȡλ (, һǧ)
+    for (i = 0; i < CT_WARMUP; i += CT_BATCH)
+    {
+        Ct_Make_Batch(secret, len, &seed);
+        for (k = 0; k < CT_BATCH && i + k < CT_WARMUP; k++)
+        {
+            v = Ct_Measure(fn, ct_in[k], secret, len, clock);
+            for (j = i + k; j > 0 && ct_warm[j - 1] > v; j--) ct_warm[j] = ct_warm[j - 1];
+            ct_warm[j] = v;
+        }
+    }
+    res->cutoff = ct_warm[CT_WARMUP * 99 / 100] + ct_warm[CT_WARMUP * 99 / 100] / 2;
+
+    for (i = 0; i < samples; i += CT_BATCH)
+    {
+        Ct_Make_Batch(secret, len, &seed);
+        for (k = 0; k < CT_BATCH; k++)
+        {
+            v = Ct_Measure(fn, ct_in[k], secret, len, clock);
+            if (v > res->cutoff)
+                res->dropped++;
+            else
+                Ct_Acc_Add(&res->bucket[ct_len[k]], v);
+        }
+
+        if (yield && (i & 0x0FFF) == 0) yield();
+    }
+
+    for (i = 1; i <= len; i++)
+    {
+        double t = fabs(Ct_Welch_T(&res->bucket[i], &res->bucket[0]));
+        if (t > res->t_max)
+        {
+            res->t_max = t;
+            res->t_len = i;
+        }
+    }
+}
@@ -0,0 +1,40 @@
+#include "ct_compare.h"
+
+/************************************************************************
+* Ƚ (ŽժҪ)
+*
+* ԭд main.c  Password_Check_Algorithm_A/B , ŲԺ
+* Ҳܱ, ʱ (ct_bench) ľǰܵͬһݴ.
+*
+* дǰ˳:  OR ۼ, ֻжһ. һ
+* жֻȡ"/", ȡڲ.
+*************************************************************************/
+
+uint8_t Ct_Compare_Xor(const uint8_t *a, const uint8_t *b, uint32_t n)
+{
+    uint8_t diff_accumulator = 0; // ۼ
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        diff_accumulator |= (a[i] ^ b[i]);
+    }
+
+    //  diff_accumulator Ϊ 0,ÿһλͬ
+    return (diff_accumulator == 0) ? 1 : 0;
+}
+
+uint8_t Ct_Compare_Sub(const uint8_t *a, const uint8_t *b, uint32_t n)
+{
+    uint8_t diff_accumulator = 0;
+
+    for (int32_t i = (int32_t)n - 1; i >= 0; i--)
+    {
+        volatile uint8_t input_val = a[i];
+        volatile uint8_t pass_val  = b[i];
+
+        // ۼӲ
+        diff_accumulator |= (uint8_t)(input_val - pass_val);
+    }
+
+    return (diff_accumulator == 0) ? 1 : 0;
+}
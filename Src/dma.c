@@ -52,6 +52,7 @@
 void MX_DMA_Init(void) 
 {
   /* DMA controller clock enable */
+  __DMA1_CLK_ENABLE();
   __DMA2_CLK_ENABLE();
 
   /* DMA interrupt init */
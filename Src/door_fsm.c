@@ -0,0 +1,150 @@
+#include "door_fsm.h"
+
+/************************************************************************
+* Ž״̬ (߼, Ӳ)
+*
+*   IDLE ----> INPUT_PWD --8λ--> VERIFY ----> OPEN --/ʱ--> IDLE
+*                     |  DEL ɾһλ          |
+*                     |   DEL         +----> ERROR --2s--> IDLE
+*                     +--30s û--> IDLE
+*
+* ԭЩжϺͷ, ,  main.c  switch , 
+* . ״̬뻺涼 Door_Fsm_t , Door_Step ÿѭ
+* һ, ֻҪĶ (DOOR_ACT_xxx), Ӳ main.c Ų.
+* УҪ Flash, ժҪ, Ҳ main.c: VERIFY ʱ
+* DOOR_ACT_VERIFY, ÷У Door_Verdict ؽ.  OPEN ֻ
+* һ· (ת¿բ Door_Enter, ).
+*
+*  Tools/ir_fuzz.c о ir_decode.c ι,
+* : input_index Խ, ûԲ, κ״̬󶼻ص.
+*************************************************************************/
+
+void Door_Clear(Door_Fsm_t *d)
+{
+    d->input_index = 0;
+    for (int i = 0; i < DOOR_PWD_LEN; i++) d->input_buf[i] = DOOR_BLANK;
+}
+
+void Door_Init(Door_Fsm_t *d)
+{
+    Door_Clear(d);
+    d->state = SYS_IDLE;
+    d->key_tick = 0;
+    d->verify_due = 0;
+    d->open_tick = 0;
+    d->err_tick = 0;
+}
+
+void Door_Enter(Door_Fsm_t *d, uint8_t state, uint32_t now)
+{
+    d->state = state;
+    switch (state)
+    {
+        case SYS_INPUT_PWD: d->key_tick = now;   break;
+        case SYS_VERIFY:    d->verify_due = now; break;
+        case SYS_OPEN:      d->open_tick = now;  break;
+        case SYS_ERROR:     d->err_tick = now;   break;
+        default:                                 break;
+    }
+}
+
+static uint32_t Door_Key(Door_Fsm_t *d, const Door_Input_t *in)
+{
+    uint32_t act = 0;
+
+    if (in->key <= 9)
+    {
+        act = DOOR_ACT_BEEP;
+        d->key_tick = in->now;
+        if (d->input_index < DOOR_PWD_LEN)
+        {
+            d->input_buf[d->input_index++] = in->key;
+            act |= DOOR_ACT_INPUT;
+        }
+        // 8λ, У (ʱɵ÷)
+        if (d->input_index >= DOOR_PWD_LEN)
+        {
+            Door_Enter(d, SYS_VERIFY, in->now);
+            act |= DOOR_ACT_STATE;
+        }
+    }
+    else if (in->key == DOOR_KEY_DEL)
+    {
+        act = DOOR_ACT_BEEP;
+        d->key_tick = in->now;
+        if (d->input_index > 0)
+        {
+            d->input_buf[--d->input_index] = DOOR_BLANK;
+            act |= DOOR_ACT_INPUT;
+        }
+    }
+    else if (in->key_long == DOOR_KEY_DEL)
+    {
+        // ס DEL: 
+        d->key_tick = in->now;
+        Door_Clear(d);
+        act = DOOR_ACT_BEEP_LONG | DOOR_ACT_INPUT;
+    }
+    else if (in->now - d->key_tick >= INPUT_TIMEOUT_TICKS)
+    {
+        // 䵽һ, һ˽
+        Door_Clear(d);
+        Door_Enter(d, SYS_IDLE, in->now);
+        act = DOOR_ACT_INPUT | DOOR_ACT_STATE;
+    }
+    return act;
+}
+
+uint32_t Door_Step(Door_Fsm_t *d, const Door_Input_t *in)
+{
+    uint32_t elapsed;
+
+    switch (d->state)
+    {
+        case SYS_IDLE:
+            if (in->key > 9) return 0;
+            Door_Clear(d);
+            Door_Enter(d, SYS_INPUT_PWD, in->now);
+            return Door_Key(d, in) | DOOR_ACT_INPUT | DOOR_ACT_STATE;
+
+        case SYS_INPUT_PWD:
+            return Door_Key(d, in);
+
+        case SYS_VERIFY:
+            // , ѭת
+            if ((int32_t)(in->now - d->verify_due) < 0) return 0;
+            return DOOR_ACT_VERIFY;
+
+        case SYS_OPEN:
+            // ͨ͹; ʱբгʱ, ౣ OPEN_HOLD_MAX_TICKS
+            elapsed = in->now - d->open_tick;
+            if (!in->departed && (elapsed < OPEN_TIMEOUT_TICKS || in->vehicle) &&
+                elapsed < OPEN_HOLD_MAX_TICKS)
+                return 0;
+            Door_Clear(d);
+            Door_Enter(d, SYS_IDLE, in->now);
+            return DOOR_ACT_CLOSE | DOOR_ACT_INPUT | DOOR_ACT_STATE;
+
+        case SYS_ERROR:
+            if (in->now - d->err_tick < ERR_HOLD_TICKS) return 0;
+            Door_Clear(d);
+            Door_Enter(d, SYS_IDLE, in->now);
+            return DOOR_ACT_INPUT | DOOR_ACT_STATE;
+
+        default:
+            Door_Clear(d);
+            Door_Enter(d, SYS_IDLE, in->now);
+            return DOOR_ACT_INPUT | DOOR_ACT_STATE;
+    }
+}
+
+/**
+  * @brief У: ˿,  (ʱ) . ֻ VERIFY Ч
+  */
+uint32_t Door_Verdict(Door_Fsm_t *d, uint8_t granted, uint32_t now)
+{
+    if (d->state != SYS_VERIFY) return 0;
+
+    Door_Enter(d, granted ? SYS_OPEN : SYS_ERROR, now);
+    return DOOR_ACT_STATE;
+}
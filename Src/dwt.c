@@ -0,0 +1,18 @@
+#include "dwt.h"
+
+/**
+  * @brief   DWT ڼ
+  * CYCCNT ϵͳλʱ, ÿζֶ
+  */
+void DWT_Cycle_Init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+// ΢
+uint32_t DWT_Cycle_To_Us(uint32_t cycles)
+{
+    return cycles / (HAL_RCC_GetHCLKFreq() / 1000000);
+}
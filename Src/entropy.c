@@ -0,0 +1,185 @@
+#include "entropy.h"
+
+/************************************************************************
+* س: Ӳ (RNG) ܽһλ, õֻӻ
+*
+* ԭΨһ"" HAL_GetTick() ż. F407  RNG  PLL48CLK ,
+* Լ 40  48MHz ڳһ 32 λ, ÿһж. ж Entropy_Push
+* , ûͽҪһ (rng.c);  RNG ͣ. ȡ (Entropy_U32)
+* ֮һ refill Ų, ȡӲӲ.
+*
+*  (ж)  (ѭ) Ļλ, ͷβֻһд, 
+* ж. ѭⲻҪȡ.
+*
+* ؿ (ͻȡ̫ RNG ) ʱú xorshift128 ,  underruns.
+* 󱸵״̬ÿһӳȡӲ, һԤĹ̶.
+*  refill (, ) ʱȫȡԺ,  seed ͹̶.
+*
+* Ӳǰ FIPS 140-2 : RNG һֻȽϻ׼,
+* ֮һͬͶ.  (Entropy_Error) Ժ.
+*
+* ͳ: ǰ, ˮλ, Լÿδ"ʼ"""ͺʱ
+* (clock ˲),  = refill_words / refill_cycles. 
+* жϺѭд, ֻͳ, żһֲҪ.
+*************************************************************************/
+
+#define ENTROPY_MASK    (ENTROPY_POOL_WORDS - 1)
+
+static uint32_t pool[ENTROPY_POOL_WORDS];
+static volatile uint32_t pool_head;      // жд
+static volatile uint32_t pool_tail;      // ѭд
+
+static Entropy_Refill_t ent_refill;
+static Entropy_Clock_t  ent_clock;
+static uint32_t ent_xs[4];               //  xorshift128
+static uint32_t ent_prev;
+static uint8_t  ent_prev_valid;
+static volatile uint32_t ent_refill_t0;  // ʼʱ
+static volatile uint32_t ent_refill_n;   // һֲ
+static Entropy_Stats_t ent_stats;
+
+typedef char entropy_pool_check[(ENTROPY_POOL_WORDS & ENTROPY_MASK) == 0 ? 1 : -1];
+
+
+static uint32_t Entropy_Fallback(void)
+{
+    uint32_t t = ent_xs[3];
+    uint32_t s = ent_xs[0];
+
+    ent_xs[3] = ent_xs[2];
+    ent_xs[2] = ent_xs[1];
+    ent_xs[1] = s;
+    t ^= t << 11;
+    t ^= t >> 8;
+    ent_xs[0] = t ^ s ^ (s >> 19);
+    return ent_xs[0];
+}
+
+void Entropy_Init(Entropy_Refill_t refill, Entropy_Clock_t clock, uint32_t seed)
+{
+    uint8_t *p = (uint8_t *)&ent_stats;
+
+    for (uint32_t i = 0; i < sizeof(ent_stats); i++) p[i] = 0;
+    ent_stats.low_water = ENTROPY_POOL_WORDS;
+    pool_head = pool_tail = 0;
+    ent_prev_valid = 0;
+    ent_refill = refill;
+    ent_clock = clock;
+
+    // splitmix չ, ȫ 0 ״̬ xorshift 
+    for (int i = 0; i < 4; i++)
+    {
+        uint32_t z = (seed += 0x9E3779B9u);
+        z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+        z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+        ent_xs[i] = (z ^ (z >> 16)) | (i == 0);
+    }
+
+    ent_refill_n = 0;
+    ent_refill_t0 = clock ? clock() : 0;
+    if (refill) refill();
+}
+
+void Entropy_Push(uint32_t w)
+{
+    uint32_t head = pool_head;
+
+    if (!ent_prev_valid)
+    {
+        ent_prev = w;
+        ent_prev_valid = 1;
+        return;
+    }
+    if (w == ent_prev)
+    {
+        ent_stats.repeats++;
+        return;
+    }
+    ent_prev = w;
+
+    if (head - pool_tail >= ENTROPY_POOL_WORDS) return;
+    pool[head & ENTROPY_MASK] = w;
+    pool_head = head + 1;
+    ent_stats.pushed++;
+    ent_refill_n++;
+
+    if (head + 1 - pool_tail == ENTROPY_POOL_WORDS && ent_clock)
+    {
+        uint32_t c = ent_clock() - ent_refill_t0;
+        ent_stats.refill_words = ent_refill_n;
+        ent_stats.refill_cycles = c;
+        if (c > ent_stats.refill_max_cycles) ent_stats.refill_max_cycles = c;
+    }
+}
+
+uint8_t Entropy_Full(void)
+{
+    return (pool_head - pool_tail) >= ENTROPY_POOL_WORDS;
+}
+
+void Entropy_Error(void)
+{
+    ent_stats.errors++;
+    ent_prev_valid = 0;
+}
+
+uint32_t Entropy_U32(void)
+{
+    uint32_t tail = pool_tail;
+    uint32_t depth = pool_head - tail;
+    uint32_t w;
+
+    ent_stats.drawn++;
+    if (depth == 0)
+    {
+        ent_stats.underruns++;
+        ent_stats.low_water = 0;
+        w = Entropy_Fallback();
+    }
+    else
+    {
+        w = pool[tail & ENTROPY_MASK];
+        if (depth == ENTROPY_POOL_WORDS)
+        {
+            // ״̬ȡߵһ, һֲʱ
+            ent_refill_n = 0;
+            if (ent_clock) ent_refill_t0 = ent_clock();
+        }
+        pool_tail = tail + 1;
+        if (depth - 1 < ent_stats.low_water) ent_stats.low_water = depth - 1;
+        ent_xs[ent_stats.drawn & 3] ^= w;       // ҲӲ
+    }
+
+    if (ent_refill) ent_refill();
+    return w;
+}
+
+/**
+  * @brief ȡ [lo, hi] ڵ, ˷ӳ (ƫ 2^-32 * , þܾ)
+  */
+uint32_t Entropy_Range(uint32_t lo, uint32_t hi)
+{
+    uint32_t n = hi - lo + 1;
+
+    if (n == 0) return Entropy_U32();   //  32 λ
+    return lo + (uint32_t)(((uint64_t)Entropy_U32() * n) >> 32);
+}
+
+void Entropy_Fill(uint8_t *buf, uint32_t len)
+{
+    while (len)
+    {
+        uint32_t w = Entropy_U32();
+        for (int i = 0; i < 4 && len; i++, len--)
+        {
+            *buf++ = (uint8_t)w;
+            w >>= 8;
+        }
+    }
+}
+
+void Entropy_GetStats(Entropy_Stats_t *st)
+{
+    *st = ent_stats;
+    st->depth = pool_head - pool_tail;
+}
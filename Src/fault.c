@@ -0,0 +1,198 @@
+#include "fault.h"
+#include "persist.h"
+#include "stdio.h"
+
+/************************************************************************
+* ֳ¼ (SRAM)
+*
+* HardFault/MemManage/BusFault/UsageFault  (stm32f4xx_it.c) ֻж
+* õ MSP  PSP, Ȼջַ֡ Fault_Capture. ջ֡,
+* CFSR/HFSR/MMFAR/BFAR ͵ʱϵͳ״̬SRAM, Ȼλ,
+* ճָ. ֻǼʮֵĶд, 16MHz ¼΢, 
+* Ź (3s) ʱ; ˶ tick  HAL, ʱ HAL ״̬.
+*
+* ٻ: ѭ״̬л//¼ Fault_Trace ֱдSRAM
+* Ļλ, ʱÿ, ֻдλ. ´ο Fault_Init Ȱ
+* ٿ (֮ѭд), Fault_Report ֳͬһ,
+* .
+*
+* ջʱջ֡ûѹ (CFSR  MSTKERR/BSTKERR), ջָѾ
+* RAM , ʱջ֡,  Fault ٳ.
+*************************************************************************/
+
+#define FAULT_MAGIC         0x544C5846u   // "FXLT"
+#define FAULT_TRACE_MAGIC   0x45434154u   // "TACE"
+#define FAULT_DUMP          ((Fault_Dump_t *)BKPSRAM_FAULT_ADDR)
+#define FAULT_RING          ((Fault_Ring_t *)(BKPSRAM_FAULT_ADDR + 0x80))
+
+#define FAULT_CFSR_STKERR   ((1u << 4) | (1u << 12))   // MSTKERR | BSTKERR
+
+typedef struct
+{
+    uint32_t magic;
+    uint32_t head;            // һдλ (һֱ, ȡλ)
+    Fault_Trace_t ent[FAULT_TRACE_LEN];
+} Fault_Ring_t;
+
+typedef char fault_size_check[(sizeof(Fault_Dump_t) <= 0x80 &&
+                               0x80 + sizeof(Fault_Ring_t) <= BKPSRAM_FAULT_SIZE) ? 1 : -1];
+
+static const char * const fault_name[] =
+{
+    "None", "HardFault", "MemManage", "BusFault", "UsageFault", "InitError"
+};
+
+static __IO uint8_t fault_state = 0;   // һ FAULT_TRC_STATE ֵ
+static Fault_Trace_t fault_trace[FAULT_TRACE_LEN];   // ǰĸ, ϵ
+static uint8_t fault_trace_valid = 0;
+
+
+static uint8_t Fault_Frame_Ok(uint32_t addr, uint32_t cfsr)
+{
+    if (cfsr & FAULT_CFSR_STKERR) return 0;
+    if (addr & 3) return 0;
+    return (addr >= SRAM1_BASE && addr + 32 <= SRAM2_BASE + 0x4000) ||
+           (addr >= CCMDATARAM_BASE && addr + 32 <= CCMDATARAM_END + 1);
+}
+
+// ܷ Persist_Init ֮ǰ, SRAM ʱӺдԼ
+static void Fault_Bkp_Open(void)
+{
+    RCC->APB1ENR |= RCC_APB1ENR_PWREN;
+    PWR->CR |= PWR_CR_DBP;
+    RCC->AHB1ENR |= RCC_AHB1ENR_BKPSRAMEN;
+}
+
+static void Fault_Save(uint32_t type, const uint32_t *frame, uint32_t exc_return, uint16_t code)
+{
+    Fault_Dump_t *d = FAULT_DUMP;
+    uint32_t cfsr = SCB->CFSR;
+    uint32_t count;
+
+    Fault_Bkp_Open();
+
+    count = (d->magic == FAULT_MAGIC) ? d->count : 0;
+    if (d->magic != FAULT_MAGIC) d->reported = 0;
+    d->magic = 0;
+
+    d->type = type;
+    d->sp = (uint32_t)frame;
+    d->exc_return = exc_return;
+    if (frame && Fault_Frame_Ok((uint32_t)frame, cfsr))
+    {
+        for (int i = 0; i < 8; i++) d->frame[i] = frame[i];
+    }
+    else
+    {
+        for (int i = 0; i < 8; i++) d->frame[i] = 0;
+    }
+    d->cfsr = cfsr;
+    d->hfsr = SCB->HFSR;
+    d->mmfar = SCB->MMFAR;
+    d->bfar = SCB->BFAR;
+    d->tick = HAL_GetTick();
+    d->state = fault_state;
+    d->trace_head = (uint8_t)FAULT_RING->head;
+    d->code = code;
+    d->count = count + 1;
+    __DSB();
+    d->magic = FAULT_MAGIC;
+    __DSB();
+}
+
+void Fault_Init(void)
+{
+    Fault_Ring_t *ring = FAULT_RING;
+
+    // Ĭֶ HardFault, ֿſóһ
+    SCB->SHCSR |= SCB_SHCSR_MEMFAULTENA_Msk | SCB_SHCSR_BUSFAULTENA_Msk | SCB_SHCSR_USGFAULTENA_Msk;
+
+    if (ring->magic != FAULT_TRACE_MAGIC)
+    {
+        ring->head = 0;
+        for (int i = 0; i < FAULT_TRACE_LEN; i++)
+        {
+            ring->ent[i].tick = 0;
+            ring->ent[i].id = 0;
+            ring->ent[i].arg = 0;
+        }
+        ring->magic = FAULT_TRACE_MAGIC;
+    }
+    else if (FAULT_DUMP->magic == FAULT_MAGIC && FAULT_DUMP->reported != FAULT_DUMP->count)
+    {
+        for (int i = 0; i < FAULT_TRACE_LEN; i++)
+        {
+            fault_trace[i] = ring->ent[(FAULT_DUMP->trace_head + i) & (FAULT_TRACE_LEN - 1)];
+        }
+        fault_trace_valid = 1;
+    }
+}
+
+void Fault_Trace(Fault_Trace_Id_t id, uint16_t arg)
+{
+    Fault_Ring_t *ring = FAULT_RING;
+    Fault_Trace_t *e = &ring->ent[ring->head & (FAULT_TRACE_LEN - 1)];
+
+    e->tick = HAL_GetTick();
+    e->id = id;
+    e->arg = arg;
+    ring->head++;
+    if (id == FAULT_TRC_STATE) fault_state = (uint8_t)arg;
+}
+
+void Fault_Capture(uint32_t *frame, uint32_t type, uint32_t exc_return)
+{
+    Fault_Save(type, frame, exc_return, 0);
+    NVIC_SystemReset();
+}
+
+void Fault_Record(uint16_t code)
+{
+    Fault_Save(FAULT_INIT, 0, 0, code);
+    NVIC_SystemReset();
+}
+
+uint32_t Fault_Count(void)
+{
+    return (FAULT_DUMP->magic == FAULT_MAGIC) ? FAULT_DUMP->count : 0;
+}
+
+/**
+  * @brief ûʹӡֳ͸, ٴϵһʼ
+  */
+void Fault_Report(void)
+{
+    Fault_Dump_t *d = FAULT_DUMP;
+
+    if (d->magic != FAULT_MAGIC || d->reported == d->count) return;
+
+    printf("\n\r [Fault] #%u %s (%u since last report), state %u, tick %u",
+           d->count, (d->type <= FAULT_INIT) ? fault_name[d->type] : "?",
+           d->count - d->reported, d->state, d->tick);
+    if (d->type == FAULT_INIT)
+    {
+        printf(", init step %u", d->code);
+    }
+    else
+    {
+        printf("\n\r         PC %08X LR %08X SP %08X xPSR %08X EXC_RETURN %08X",
+               d->frame[6], d->frame[5], d->sp, d->frame[7], d->exc_return);
+        printf("\n\r         R0 %08X R1 %08X R2 %08X R3 %08X R12 %08X",
+               d->frame[0], d->frame[1], d->frame[2], d->frame[3], d->frame[4]);
+        printf("\n\r         CFSR %08X HFSR %08X MMFAR %08X BFAR %08X",
+               d->cfsr, d->hfsr, d->mmfar, d->bfar);
+    }
+
+    if (fault_trace_valid)
+    {
+        printf("\n\r         trace (tick id/arg):");
+        for (int i = 0; i < FAULT_TRACE_LEN; i++)
+        {
+            if (fault_trace[i].id == 0) continue;
+            printf(" %u:%u/%u", fault_trace[i].tick, fault_trace[i].id, fault_trace[i].arg);
+        }
+        fault_trace_valid = 0;
+    }
+
+    d->reported = d->count;
+}
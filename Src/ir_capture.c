@@ -0,0 +1,136 @@
+#include "ir_capture.h"
+#include "stm32f4xx_hal.h"
+#include "crc.h"
+#include "usart.h"
+#include "stdio.h"
+
+/************************************************************************
+* ԭʼץ (PF15)
+*
+* ֳңûӦ, ⿴֪ƫ˻Ǹ. ڷ
+* IR_CAP_START_CMD , жϰÿ (ƽ + һص us, 
+* 16 λ) ˳ RAM ,  IR_CAP_LEN ͣ, ͷһ.
+* ճ, ץӰ쿪բ.
+*
+*  IR_CAP_DUMP_CMD ֹͣץ, ӡһʾʰ
+* ֡ͷ + ȫԭȥ ( IR_Capture_Head_t). ѭÿȦͼĴ
+* վһֽ, ; ڼ printf . 4KB Լ 0.4s.
+*
+*  RAM , ʱλ, ץʼ IR_CAP_HOLD_TICKS
+*  (Լڼ) Ƴٶʱλ.  Tools/ir_replay.c 
+* .irc ļ, úͬһ ir_decode.c ط, ӽع.
+*************************************************************************/
+
+typedef enum
+{
+    CAP_IDLE = 0,             // ûץ, ѾҪ
+    CAP_RUN,                  // ץ
+    CAP_HOLD,                 // ͣ, ȵ
+    CAP_DUMP                  // ڵ
+} IR_Cap_State_t;
+
+static uint16_t ir_cap_buf[IR_CAP_LEN];
+static __IO uint32_t ir_cap_count = 0;
+static __IO uint32_t ir_cap_dropped = 0;
+static __IO uint8_t  ir_cap_state = CAP_IDLE;
+static uint32_t ir_cap_tick = 0;             // ʼץʱ
+static IR_Capture_Head_t ir_cap_head;
+static uint32_t ir_cap_sent = 0;             // ѷֽ
+
+typedef char ir_cap_len_check[(IR_CAP_LEN % 2 == 0 && IR_CAP_LEN <= 0xFFFF) ? 1 : -1];
+
+
+void IR_Capture_Edge(uint8_t level, uint32_t dt_us)
+{
+    uint32_t n;
+
+    if (ir_cap_state != CAP_RUN) return;
+
+    n = ir_cap_count;
+    if (n >= IR_CAP_LEN)
+    {
+        ir_cap_dropped++;
+        return;
+    }
+    ir_cap_buf[n] = IR_CAP_ENTRY(dt_us, level);
+    ir_cap_count = n + 1;
+}
+
+void IR_Capture_Start(void)
+{
+    if (ir_cap_state == CAP_DUMP) return;
+
+    ir_cap_state = CAP_IDLE;     // ͣסж, 
+    ir_cap_count = 0;
+    ir_cap_dropped = 0;
+    ir_cap_tick = HAL_GetTick();
+    ir_cap_state = CAP_RUN;
+    printf("\r\n [IR] Capture started, up to %u edges", IR_CAP_LEN);
+}
+
+uint8_t IR_Capture_Dump_Start(void)
+{
+    uint32_t n;
+
+    if (ir_cap_state == CAP_DUMP) return 0;
+
+    ir_cap_state = CAP_HOLD;     // ֹͣץ, ļٱ
+    n = ir_cap_count;
+    if (n & 1) ir_cap_buf[n] = 0;
+
+    ir_cap_head.magic    = IR_CAP_MAGIC;
+    ir_cap_head.version  = IR_CAP_VERSION;
+    ir_cap_head.count    = (uint16_t)n;
+    ir_cap_head.dropped  = ir_cap_dropped;
+    ir_cap_head.data_crc = CRC_Calc32((const uint32_t *)ir_cap_buf, (n + 1) / 2);
+    ir_cap_head.crc      = CRC_Calc32((const uint32_t *)&ir_cap_head, 4);
+
+    printf("\r\n [IR] Capture dump %u edges (%u dropped)\r\n", n, ir_cap_head.dropped);
+
+    ir_cap_sent = 0;
+    ir_cap_state = CAP_DUMP;
+    return 1;
+}
+
+void IR_Capture_Task(void)
+{
+    uint32_t total;
+    uint8_t c;
+
+    // ͣŵȵݹʱ޾Ͳʱλ
+    if ((ir_cap_state == CAP_RUN || ir_cap_state == CAP_HOLD) &&
+        HAL_GetTick() - ir_cap_tick >= IR_CAP_HOLD_TICKS)
+    {
+        ir_cap_state = CAP_IDLE;
+        return;
+    }
+
+    if (ir_cap_state != CAP_DUMP) return;
+    if (!__HAL_UART_GET_FLAG(&huart1, UART_FLAG_TXE)) return;
+
+    total = sizeof(ir_cap_head) + ir_cap_head.count * 2u;
+    if (ir_cap_sent >= total)
+    {
+        if (!__HAL_UART_GET_FLAG(&huart1, UART_FLAG_TC)) return;
+        ir_cap_state = CAP_IDLE;
+        printf("\r\n [IR] Capture dump done.");
+        return;
+    }
+
+    if (ir_cap_sent < sizeof(ir_cap_head))
+        c = ((const uint8_t *)&ir_cap_head)[ir_cap_sent];
+    else
+        c = ((const uint8_t *)ir_cap_buf)[ir_cap_sent - sizeof(ir_cap_head)];
+    huart1.Instance->DR = c;
+    ir_cap_sent++;
+}
+
+uint8_t IR_Capture_Busy(void)
+{
+    return ir_cap_state != CAP_IDLE;
+}
+
+uint8_t IR_Capture_Dumping(void)
+{
+    return ir_cap_state == CAP_DUMP;
+}
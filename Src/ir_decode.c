@@ -0,0 +1,139 @@
+#include "ir_decode.h"
+
+/************************************************************************
+* NEC  (߼, Ӳ)
+*
+* ͷǷ: иߵƽ, زʱ͵ƽ. PF15 ضж,
+* ÿذ "غĵƽ + һصʱ"  IR_Decode_Edge:
+*
+*   1      뿪ʼ, ʱ
+*   2      9ms ͵ƽ
+*   3      4.5ms: ֡ʼ / 2.25ms: ظ, ˽
+*   4~67     ÿλһ (560us ز) һ½ (: 560us '0',
+*                1690us '1'), λȵ,  67  32 λ
+*
+* ǰж SysTick ݼ GlobalTimingDelay100us  (100us һ),
+* ж DWT ڼ us ٵ, ڻԭǼ.
+* ϴھʹͷ, ǰزٵµĿʼ.
+* ֻ stdint, Ͽ԰ץĲԭιط (Tools/ir_replay.c).
+*
+* ֡ж: ַ/, סʱظͳ. λ
+* ʹӡ RemoteInfrared.c, ֻʱ״̬, ģ (Tools/ir_fuzz.c)
+* ӱһ·ιŽ״̬õľ⼸.
+*************************************************************************/
+
+#define IR_DEC_IN(t, lo, hi)  ((t) > (lo) && (t) < (hi))
+
+void IR_Decode_Reset(IR_Decoder_t *d)
+{
+    d->edges = 0;
+    d->code = 0;
+}
+
+uint8_t IR_Decode_Edge(IR_Decoder_t *d, uint8_t level, uint32_t dt_us, uint32_t *code)
+{
+    uint8_t n = ++d->edges;
+
+    if (n == 1)
+    {
+        if (level) d->edges = 0;     // ߵƽЧ
+        return IR_DEC_NONE;
+    }
+
+    if (n == 2)
+    {
+        if (!level || !IR_DEC_IN(dt_us, IR_DEC_LEAD_MIN, IR_DEC_LEAD_MAX)) d->edges = 0;
+        return IR_DEC_NONE;
+    }
+
+    if (n == 3)
+    {
+        if (!level && IR_DEC_IN(dt_us, IR_DEC_SPACE_MIN, IR_DEC_SPACE_MAX)) return IR_DEC_NONE;
+
+        d->edges = 0;
+        if (!level && IR_DEC_IN(dt_us, IR_DEC_REPEAT_MIN, IR_DEC_REPEAT_MAX)) return IR_DEC_REPEAT;
+        return IR_DEC_NONE;
+    }
+
+    if (n > IR_DEC_EDGES)
+    {
+        d->edges = 0;                // λ
+        return IR_DEC_NONE;
+    }
+
+    if (level)
+    {
+        if (!IR_DEC_IN(dt_us, IR_DEC_BIT_MIN, IR_DEC_BIT_MAX)) d->edges = 0;
+        return IR_DEC_NONE;
+    }
+
+    if (IR_DEC_IN(dt_us, IR_DEC_BIT_MIN, IR_DEC_BIT_MAX))
+        d->code <<= 1;               // '0'
+    else if (IR_DEC_IN(dt_us, IR_DEC_ONE_MIN, IR_DEC_ONE_MAX))
+        d->code = (d->code << 1) | 1;  // '1'
+    else
+    {
+        d->edges = 0;
+        return IR_DEC_NONE;
+    }
+
+    if (n == IR_DEC_EDGES)
+    {
+        d->edges = 0;
+        *code = d->code;
+        return IR_DEC_FRAME;
+    }
+    return IR_DEC_NONE;
+}
+
+/**
+  * @brief Ҫͷ; ַͷǱ׼ NEC (8 λ),
+  * Բϰչ NEC (16 λ, ֽȵ)
+  */
+uint8_t IR_Decode_Split(uint32_t raw, uint16_t *addr, uint8_t *cmd)
+{
+    uint8_t id = (uint8_t)(raw >> 24);
+    uint8_t id_not = (uint8_t)(raw >> 16);
+    uint8_t c = (uint8_t)(raw >> 8);
+
+    if ((uint8_t)(c ^ raw) != 0xFF) return 0;
+
+    *cmd = c;
+    if ((uint8_t)(id ^ id_not) == 0xFF)
+    {
+        *addr = id;
+        return 1;
+    }
+    *addr = ((uint16_t)id << 8) | id_not;
+    return 2;
+}
+
+void IR_Hold_Press(IR_Hold_t *h, uint8_t key, uint8_t id, uint32_t tick)
+{
+    h->key = key;
+    h->id = id;
+    h->long_sent = 0;
+    h->press_tick = tick;
+    h->last_tick = tick;
+}
+
+/**
+  * @brief ֡һ° (סңֻظ). ظһ֡/һ
+  * ظ벻 IR_REPEAT_GAP 㰴ס, ɿ. Ӱס
+  * IR_LONG_TICKS һγ, ֮ظ
+  */
+uint8_t IR_Hold_Repeat(IR_Hold_t *h, uint32_t tick)
+{
+    if (h->key == IR_HOLD_NONE || tick - h->last_tick > IR_REPEAT_GAP)
+    {
+        h->key = IR_HOLD_NONE;
+        return IR_HOLD_ORPHAN;
+    }
+    h->last_tick = tick;
+    if (!h->long_sent && tick - h->press_tick >= IR_LONG_TICKS)
+    {
+        h->long_sent = 1;
+        return IR_HOLD_LONG;
+    }
+    return IR_HOLD_REPEAT;
+}
@@ -0,0 +1,321 @@
+#include "ir_keymap.h"
+#include "kv_store.h"
+#include "dwt.h"
+#include "string.h"
+#include "stdio.h"
+
+/************************************************************************
+* ңؼλ (ѧϰģʽ)
+*
+* ԭλд Remote_Infrared_KeyDeCode  switch , ֻ, 
+* ĸң (ַ). ڰ (Э, ַ, ) һſѰַĹϣ,
+* ̽, װʲ 3/4, һһһ, ¼˼ң޹.
+*
+* ǳ־ûĸʽ:  i ɼֵ KV_KEY_KEYMAP_BASE + i,
+* ԭ, ². ɾú (Ĺ): ͬһĿ
+* ǰŲ, Ųĸдλɾλ, ;һظ.
+*
+* ѧϰ:  I , ΰң 0~9, DEL, 11 յһд;
+* 30s ûͬһλö. ѧϰڼѭʱλ
+* (ֻ RAM ),  30s ʱ. ң J ַɾ
+* ȫ, ѧһµ, ճ.
+*
+* һζûѧʱóĬϱ (ԭ switch , Э 0 ַܵ),
+* һѧϰɹ, ֻѧң.
+*************************************************************************/
+
+#define KEYMAP_MASK        (KEYMAP_SLOTS - 1)
+#define KEYMAP_HASH_SHIFT  26      // 32 - log2(KEYMAP_SLOTS)
+
+typedef char keymap_slots_check[((1u << (32 - KEYMAP_HASH_SHIFT)) == KEYMAP_SLOTS &&
+                                 KEYMAP_SLOTS <= 64) ? 1 : -1];
+
+// 0~9, DEL: ԭ switch 
+static const uint8_t keymap_factory_cmd[KEYMAP_LEARN_NUM] =
+{
+    0xB8, 0x08, 0x88, 0x48, 0xC8, 0x28, 0xA8, 0xE8, 0x18, 0x98, 0x78
+};
+
+static Keymap_Entry_t keymap[KEYMAP_SLOTS];
+static Keymap_Stats_t keymap_stats;
+
+static uint8_t  learn_active = 0;
+static uint8_t  learn_step = 0;
+static uint32_t learn_tick = 0;
+static uint32_t learn_code[KEYMAP_LEARN_NUM];
+
+
+static uint32_t Keymap_Hash(uint32_t code)
+{
+    return (code * 0x9E3779B1u) >> KEYMAP_HASH_SHIFT;
+}
+
+static uint8_t Keymap_Learn_Key(uint8_t step)
+{
+    return (step < 10) ? step : KEYMAP_KEY_DEL;
+}
+
+static void Keymap_Print_Key(uint8_t key)
+{
+    if (key == KEYMAP_KEY_DEL)
+        printf("DEL");
+    else
+        printf("%u", key);
+}
+
+/**
+  * @brief  code ڵĸ; ûоͷ̽ϵһո,  -1
+  */
+static int32_t Keymap_Find(uint32_t code, uint8_t *probes)
+{
+    uint32_t i = Keymap_Hash(code);
+
+    for (uint32_t n = 1; n <= KEYMAP_SLOTS; n++, i = (i + 1) & KEYMAP_MASK)
+    {
+        if (keymap[i].code == code || keymap[i].code == 0)
+        {
+            *probes = n;
+            return (int32_t)i;
+        }
+    }
+    *probes = KEYMAP_SLOTS;
+    return -1;
+}
+
+// ֻ RAM, ڸ
+static int32_t Keymap_Put(uint32_t code, uint8_t key)
+{
+    uint8_t probes;
+    int32_t s = Keymap_Find(code, &probes);
+
+    if (s < 0) return -1;
+    keymap[s].code = code;
+    keymap[s].key = key;
+    return s;
+}
+
+void Keymap_Init(void)
+{
+    memset(keymap, 0, sizeof(keymap));
+    memset(&keymap_stats, 0, sizeof(keymap_stats));
+    learn_active = 0;
+
+    for (int i = 0; i < KEYMAP_SLOTS; i++)
+    {
+        if (KV_Get(KV_KEY_KEYMAP_BASE + i, &keymap[i], sizeof(Keymap_Entry_t)) == sizeof(Keymap_Entry_t) &&
+            keymap[i].code != 0)
+        {
+            keymap_stats.count++;
+        }
+        else
+        {
+            memset(&keymap[i], 0, sizeof(Keymap_Entry_t));
+        }
+    }
+
+    if (keymap_stats.count == 0)
+    {
+        keymap_stats.factory = 1;
+        for (int k = 0; k < KEYMAP_LEARN_NUM; k++)
+        {
+            Keymap_Put(KEYMAP_CODE(KEYMAP_PROTO_ANY, 0, keymap_factory_cmd[k]), Keymap_Learn_Key(k));
+        }
+    }
+}
+
+uint8_t Keymap_Lookup(uint32_t code)
+{
+    uint32_t t0 = DWT_CYCCNT_GET();
+    uint8_t key = KEYMAP_KEY_NONE;
+    uint8_t probes;
+    int32_t s;
+
+    if (code == 0) return KEYMAP_KEY_NONE;
+    if (keymap_stats.factory) code = KEYMAP_CODE(KEYMAP_PROTO_ANY, 0, code & 0xFF);
+
+    s = Keymap_Find(code, &probes);
+    if (s >= 0 && keymap[s].code == code) key = keymap[s].key;
+
+    keymap_stats.lookups++;
+    keymap_stats.lookup_cycles = DWT_CYCCNT_GET() - t0;
+    if (keymap_stats.lookup_cycles > keymap_stats.lookup_max_cycles)
+        keymap_stats.lookup_max_cycles = keymap_stats.lookup_cycles;
+    if (probes > keymap_stats.probe_max) keymap_stats.probe_max = probes;
+    return key;
+}
+
+uint8_t Keymap_Learn_Start(void)
+{
+    learn_active = 1;
+    learn_step = 0;
+    learn_tick = HAL_GetTick();
+    printf("\r\n [IR] Learning, press 0 on the new remote");
+    return 1;
+}
+
+uint8_t Keymap_Learning(void)
+{
+    return learn_active;
+}
+
+static void Keymap_Learn_Commit(void)
+{
+    uint16_t need = 0;
+    uint8_t probes;
+    int32_t s;
+
+    if (keymap_stats.factory)
+    {
+        memset(keymap, 0, sizeof(keymap));   // һѧϰ: 
+        keymap_stats.factory = 0;
+    }
+
+    for (int k = 0; k < KEYMAP_LEARN_NUM; k++)
+    {
+        s = Keymap_Find(learn_code[k], &probes);
+        if (s < 0 || keymap[s].code == 0) need++;
+    }
+    if (keymap_stats.count + need > KEYMAP_MAX)
+    {
+        printf("\r\n [IR] Keymap full (%u/%u), forget a remote first (J)", keymap_stats.count, KEYMAP_MAX);
+        return;
+    }
+
+    for (int k = 0; k < KEYMAP_LEARN_NUM; k++)
+    {
+        s = Keymap_Put(learn_code[k], Keymap_Learn_Key((uint8_t)k));
+        KV_Set(KV_KEY_KEYMAP_BASE + s, &keymap[s], sizeof(Keymap_Entry_t));
+    }
+    keymap_stats.count += need;
+    printf("\r\n [IR] Learned remote 0x%04X, %u/%u keys in table",
+           (unsigned)((learn_code[0] >> 8) & 0xFFFF), keymap_stats.count, KEYMAP_MAX);
+}
+
+void Keymap_Learn_Feed(uint32_t code)
+{
+    if (!learn_active) return;
+
+    for (int k = 0; k < learn_step; k++)
+    {
+        if (learn_code[k] == code)
+        {
+            printf("\r\n [IR] That button is already ");
+            Keymap_Print_Key(Keymap_Learn_Key((uint8_t)k));
+            printf(", press ");
+            Keymap_Print_Key(Keymap_Learn_Key(learn_step));
+            return;
+        }
+    }
+
+    learn_code[learn_step++] = code;
+    learn_tick = HAL_GetTick();
+    if (learn_step < KEYMAP_LEARN_NUM)
+    {
+        printf("\r\n [IR] Got 0x%08X, press ", code);
+        Keymap_Print_Key(Keymap_Learn_Key(learn_step));
+        return;
+    }
+
+    learn_active = 0;
+    Keymap_Learn_Commit();
+}
+
+void Keymap_Task(void)
+{
+    if (learn_active && HAL_GetTick() - learn_tick >= KEYMAP_LEARN_TICKS)
+    {
+        learn_active = 0;
+        printf("\r\n [IR] Learning timed out, nothing saved");
+    }
+}
+
+/**
+  * @brief ɾ i , ͬһǰŲŲ (Ĺ).
+  * Ĺĸ dirty , ֮ͳһдؼֵ
+  */
+static void Keymap_Remove(uint32_t i, uint32_t *dirty)
+{
+    uint32_t j = i;
+
+    memset(&keymap[i], 0, sizeof(Keymap_Entry_t));
+    dirty[i >> 5] |= 1u << (i & 31);
+
+    for (;;)
+    {
+        j = (j + 1) & KEYMAP_MASK;
+        if (keymap[j].code == 0) break;
+
+        // j Ŀλ h  (i, j] ֮, ͿŲ i
+        uint32_t h = Keymap_Hash(keymap[j].code);
+        if (((j - h) & KEYMAP_MASK) >= ((j - i) & KEYMAP_MASK))
+        {
+            keymap[i] = keymap[j];
+            memset(&keymap[j], 0, sizeof(Keymap_Entry_t));
+            dirty[j >> 5] |= 1u << (j & 31);
+            i = j;
+        }
+    }
+}
+
+uint16_t Keymap_Forget(uint16_t addr)
+{
+    uint32_t dirty[2] = { 0, 0 };
+    uint16_t removed = 0;
+    uint8_t again;
+
+    if (keymap_stats.factory) return 0;
+
+    // ƿܰѺĿŲѾĸ, һֱɨûпɾΪֹ
+    do
+    {
+        again = 0;
+        for (uint32_t i = 0; i < KEYMAP_SLOTS; i++)
+        {
+            uint32_t code = keymap[i].code;
+            if (code != 0 && ((code >> 8) & 0xFFFF) == addr)
+            {
+                Keymap_Remove(i, dirty);
+                removed++;
+                again = 1;
+            }
+        }
+    } while (again);
+
+    // дŲȥλ, ɾڿյĸ
+    for (uint32_t i = 0; i < KEYMAP_SLOTS; i++)
+    {
+        if ((dirty[i >> 5] & (1u << (i & 31))) && keymap[i].code != 0)
+            KV_Set(KV_KEY_KEYMAP_BASE + i, &keymap[i], sizeof(Keymap_Entry_t));
+    }
+    for (uint32_t i = 0; i < KEYMAP_SLOTS; i++)
+    {
+        if ((dirty[i >> 5] & (1u << (i & 31))) && keymap[i].code == 0)
+            KV_Delete(KV_KEY_KEYMAP_BASE + i);
+    }
+
+    keymap_stats.count -= removed;
+    return removed;
+}
+
+void Keymap_Report(void)
+{
+    printf("\r\n [IR] Keymap %u/%u%s, lookup %u us (max %u us, %u probes)",
+           keymap_stats.count, KEYMAP_MAX, keymap_stats.factory ? " (factory)" : "",
+           DWT_Cycle_To_Us(keymap_stats.lookup_cycles),
+           DWT_Cycle_To_Us(keymap_stats.lookup_max_cycles), keymap_stats.probe_max);
+
+    for (int i = 0; i < KEYMAP_SLOTS; i++)
+    {
+        uint32_t code = keymap[i].code;
+        if (code == 0) continue;
+
+        printf("\r\n [IR]   %2u: proto %u addr 0x%04X cmd 0x%02X -> ", i,
+               (unsigned)(code >> 24), (unsigned)((code >> 8) & 0xFFFF), (unsigned)(code & 0xFF));
+        Keymap_Print_Key(keymap[i].key);
+    }
+}
+
+void Keymap_GetStats(Keymap_Stats_t *st)
+{
+    *st = keymap_stats;
+}
@@ -0,0 +1,324 @@
+#include "kv_store.h"
+#include "crc.h"
+#include "dwt.h"
+#include "string.h"
+#include "stdio.h"
+
+/************************************************************************
+* Flash ֵ (10/11, 128KB, 粻)
+*
+* SRAM ֻܸλֳ, ϵû; Ҫڱ
+* . , κʱֻһ"ǰ":
+*
+*   | ͷ 16B | ¼ 24B | ¼ 24B | ... | ̬ 0xFF ... |
+*
+* ֻ׷: һֵβдһ¼¼, ɵԭ, ԺΪ׼.
+* ÿ¼ CRC (Ӳ CRC Ԫ). д¼ʱһд, CRC д:
+* дһļ¼λѱռ,  CRC Բ, ɨʱ.
+*
+* ǰд: һ, ÿ¼¼ȥ, д
+* ͷ (һ, magic д). ;λʱûͷ, .
+* ͷʱȡµ. ϲ, ´д֮ǰٲ.
+*
+* ͷɨһ鵱ǰ,  RAM ｨ  -> ¼ַ ı, ֮Ҿ
+* һ±. ɨ KV_REC_NUM , ʱϽ, ʵ index_us.
+*
+*  16 λ: ֽ key, ҳȡԭ reserved . ȵ
+* ¼ 0xFFFF, ö 0 ҳ, Ǩ. ÿ 4 ֽ,
+* KV_KEY_MAX  RAM ôı (ʱҪһµ).
+*
+* ע:  Bank дڼ CPU ȡָͣס (һ 1~2s), жҲ
+* ͣ. ֻдʱ, ; ǰιһοŹ.
+*************************************************************************/
+
+#define KV_MAGIC          0x4B565331u   // "KVS1"
+#define KV_SECTOR_SIZE    0x20000
+#define KV_ERASED         0xFFFFFFFFu
+#define KV_REC_WORDS      6
+#define KV_REC_NUM        ((KV_SECTOR_SIZE - sizeof(KV_Head_t)) / sizeof(KV_Record_t))
+
+typedef struct
+{
+    uint32_t magic;           // д, 
+    uint32_t gen;
+    uint32_t gen_inv;         // ~gen
+    uint32_t reserved;
+} KV_Head_t;
+
+typedef struct
+{
+    uint8_t  key;             // ĵֽ
+    uint8_t  len;             // 0: ɾ
+    uint16_t page_inv;        // ~ҳ, 0 ҳ 0xFFFF; len <= 16, ֲǲ̬
+    uint8_t  value[KV_VALUE_MAX];
+    uint32_t crc;             // ǰ5ֵ CRC
+} KV_Record_t;
+
+#define KV_REC_KEY(rec)   ((uint16_t)(((uint16_t)~(rec)->page_inv << 8) | (rec)->key))
+
+typedef char kv_size_check[(sizeof(KV_Record_t) == KV_REC_WORDS * 4 &&
+                            sizeof(KV_Head_t) == 16) ? 1 : -1];
+
+static const uint32_t kv_base[2]   = { 0x080C0000u, 0x080E0000u };
+static const uint32_t kv_sector[2] = { FLASH_SECTOR_10, FLASH_SECTOR_11 };
+
+static const KV_Record_t *kv_index[KV_KEY_MAX];   // ÿ¼¼, NULL: û
+static const KV_Record_t *kv_index_new[KV_KEY_MAX];   // , ջֻ 1KB Ų
+static int8_t   kv_active = -1;
+static uint32_t kv_gen = 0;
+static uint32_t kv_next = 0;                      // һ¼д
+static KV_Stats_t kv_stats;
+
+
+static void KV_Cache_Flush(void)
+{
+    // ݻܻд֮ǰ 0xFF, дˢһٻض
+    if (FLASH->ACR & FLASH_ACR_DCEN)
+    {
+        __HAL_FLASH_DATA_CACHE_DISABLE();
+        __HAL_FLASH_DATA_CACHE_RESET();
+        __HAL_FLASH_DATA_CACHE_ENABLE();
+    }
+}
+
+static uint8_t KV_Program(uint32_t addr, const uint32_t *w, uint32_t words)
+{
+    uint8_t ok = 1;
+
+    HAL_FLASH_Unlock();
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR |
+                           FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR);
+    for (uint32_t i = 0; i < words && ok; i++)
+    {
+        ok = (HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, addr + i * 4, w[i]) == HAL_OK);
+    }
+    HAL_FLASH_Lock();
+    KV_Cache_Flush();
+
+    return ok && memcmp((const void *)addr, w, words * 4) == 0;
+}
+
+static uint8_t KV_Erase(uint8_t n)
+{
+    FLASH_EraseInitTypeDef erase;
+    uint32_t err = 0;
+    HAL_StatusTypeDef st;
+
+    erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+    erase.Sector = kv_sector[n];
+    erase.NbSectors = 1;
+    erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+
+    IWDG->KR = IWDG_KEY_RELOAD;   // Ź 3s, һ 128KB  2s
+
+    HAL_FLASH_Unlock();
+    __HAL_FLASH_CLEAR_FLAG(FLASH_FLAG_EOP | FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR |
+                           FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR);
+    st = HAL_FLASHEx_Erase(&erase, &err);
+    HAL_FLASH_Lock();
+
+    IWDG->KR = IWDG_KEY_RELOAD;
+    return st == HAL_OK;
+}
+
+static uint8_t KV_Head_Valid(uint8_t n)
+{
+    const KV_Head_t *h = (const KV_Head_t *)kv_base[n];
+    return h->magic == KV_MAGIC && h->gen == ~h->gen_inv;
+}
+
+// д, д magic
+static uint8_t KV_Write_Head(uint8_t n, uint32_t gen)
+{
+    uint32_t w[2];
+
+    w[0] = gen;
+    w[1] = ~gen;
+    if (!KV_Program(kv_base[n] + 4, w, 2)) return 0;
+    w[0] = KV_MAGIC;
+    return KV_Program(kv_base[n], w, 1);
+}
+
+static uint8_t KV_Record_Valid(const KV_Record_t *rec)
+{
+    return KV_REC_KEY(rec) < KV_KEY_MAX && rec->len <= KV_VALUE_MAX &&
+           rec->crc == CRC_Calc32((const uint32_t *)rec, KV_REC_WORDS - 1);
+}
+
+static uint8_t KV_Write_Record(uint32_t addr, uint16_t key, const void *val, uint8_t len)
+{
+    KV_Record_t rec;
+
+    memset(&rec, 0xFF, sizeof(rec));
+    rec.key = (uint8_t)key;
+    rec.len = len;
+    rec.page_inv = (uint16_t)~(key >> 8);
+    if (len) memcpy(rec.value, val, len);
+    rec.crc = CRC_Calc32((const uint32_t *)&rec, KV_REC_WORDS - 1);
+
+    return KV_Program(addr, (const uint32_t *)&rec, KV_REC_WORDS);
+}
+
+/**
+  * @brief : ÿ¼¼ᵽһ, ɹлȥ
+  */
+static uint8_t KV_Collect(void)
+{
+    uint8_t to = (kv_active == 0) ? 1 : 0;
+    uint32_t addr = kv_base[to] + sizeof(KV_Head_t);
+    uint16_t keys = 0;
+    const KV_Record_t **index = kv_index_new;   // ͷд֮ǰ kv_index
+
+    if (!KV_Erase(to)) return 0;
+
+    for (int k = 0; k < KV_KEY_MAX; k++)
+    {
+        const KV_Record_t *rec = kv_index[k];
+        index[k] = NULL;
+        if (rec == NULL) continue;
+
+        if (!KV_Write_Record(addr, (uint16_t)k, rec->value, rec->len)) return 0;
+        index[k] = (const KV_Record_t *)addr;
+        addr += sizeof(KV_Record_t);
+        keys++;
+    }
+
+    if (!KV_Write_Head(to, kv_gen + 1)) return 0;
+
+    memcpy(kv_index, index, sizeof(kv_index));
+    kv_active = to;
+    kv_gen++;
+    kv_next = addr;
+
+    kv_stats.gen = kv_gen;
+    kv_stats.used = keys;
+    kv_stats.keys = keys;
+    kv_stats.gc_count++;
+    return 1;
+}
+
+void KV_Init(void)
+{
+    uint8_t valid_a, valid_b;
+    uint32_t t0, addr, end;
+
+    memset(kv_index, 0, sizeof(kv_index));
+    memset(&kv_stats, 0, sizeof(kv_stats));
+    kv_stats.capacity = KV_REC_NUM;
+    kv_active = -1;
+
+    valid_a = KV_Head_Valid(0);
+    valid_b = KV_Head_Valid(1);
+
+    if (valid_a && valid_b)
+    {
+        int32_t d = (int32_t)(((const KV_Head_t *)kv_base[1])->gen - ((const KV_Head_t *)kv_base[0])->gen);
+        kv_active = (d > 0) ? 1 : 0;
+    }
+    else if (valid_a)
+        kv_active = 0;
+    else if (valid_b)
+        kv_active = 1;
+    else
+    {
+        // ȫоƬ: ʽ10
+        printf("\r\n [KV] No valid sector, formatting...");
+        if (!KV_Erase(0) || !KV_Write_Head(0, 1)) return;
+        kv_active = 0;
+    }
+
+    kv_gen = ((const KV_Head_t *)kv_base[kv_active])->gen;
+    kv_stats.gen = kv_gen;
+
+    t0 = DWT_CYCCNT_GET();
+    addr = kv_base[kv_active] + sizeof(KV_Head_t);
+    end = addr + KV_REC_NUM * sizeof(KV_Record_t);
+    for (; addr < end; addr += sizeof(KV_Record_t))
+    {
+        const KV_Record_t *rec = (const KV_Record_t *)addr;
+
+        if (*(const uint32_t *)rec == KV_ERASED) break;   // ûд, 涼ǿյ
+
+        if (KV_Record_Valid(rec))
+            kv_index[KV_REC_KEY(rec)] = rec->len ? rec : NULL;
+        else
+            kv_stats.bad++;
+    }
+    kv_next = addr;
+    kv_stats.index_us = DWT_Cycle_To_Us(DWT_CYCCNT_GET() - t0);
+
+    kv_stats.used = (kv_next - kv_base[kv_active] - sizeof(KV_Head_t)) / sizeof(KV_Record_t);
+    for (int k = 0; k < KV_KEY_MAX; k++)
+    {
+        if (kv_index[k]) kv_stats.keys++;
+    }
+}
+
+uint8_t KV_Get(uint16_t key, void *buf, uint8_t size)
+{
+    const KV_Record_t *rec;
+
+    if (key >= KV_KEY_MAX) return 0;
+    rec = kv_index[key];
+    if (rec == NULL || rec->len > size) return 0;
+
+    memcpy(buf, rec->value, rec->len);
+    return rec->len;
+}
+
+static uint8_t KV_Append(uint16_t key, const void *val, uint8_t len)
+{
+    uint32_t end;
+
+    if (kv_active < 0 || key >= KV_KEY_MAX || len > KV_VALUE_MAX) return 0;
+
+    // дļ¼λֻ, һ
+    for (int retry = 0; retry < 2; retry++)
+    {
+        end = kv_base[kv_active] + sizeof(KV_Head_t) + KV_REC_NUM * sizeof(KV_Record_t);
+        if (kv_next >= end)
+        {
+            if (!KV_Collect()) return 0;
+        }
+
+        if (KV_Write_Record(kv_next, key, val, len))
+        {
+            if (kv_index[key] == NULL && len) kv_stats.keys++;
+            if (kv_index[key] != NULL && !len) kv_stats.keys--;
+            kv_index[key] = len ? (const KV_Record_t *)kv_next : NULL;
+            kv_next += sizeof(KV_Record_t);
+            kv_stats.used++;
+            return 1;
+        }
+        kv_next += sizeof(KV_Record_t);
+        kv_stats.used++;
+        kv_stats.bad++;
+    }
+    return 0;
+}
+
+uint8_t KV_Set(uint16_t key, const void *val, uint8_t len)
+{
+    const KV_Record_t *rec;
+
+    if (key >= KV_KEY_MAX || len == 0 || len > KV_VALUE_MAX) return 0;
+
+    // ֵûͲд, ʡд
+    rec = kv_index[key];
+    if (rec != NULL && rec->len == len && memcmp(rec->value, val, len) == 0) return 1;
+
+    return KV_Append(key, val, len);
+}
+
+uint8_t KV_Delete(uint16_t key)
+{
+    if (key >= KV_KEY_MAX) return 0;
+    if (kv_index[key] == NULL) return 1;
+
+    return KV_Append(key, NULL, 0);
+}
+
+void KV_GetStats(KV_Stats_t *st)
+{
+    *st = kv_stats;
+}
@@ -0,0 +1,235 @@
+#include "light_ctrl.h"
+#include "persist.h"
+#include "dwt.h"
+#include "stdio.h"
+#include "arm_math.h"
+
+/************************************************************************
+*  (ADC3_IN4, PF6, )
+*
+* ÿһͻ: ADC Լ 4032Hz, 2  1 õԼ 2016Hz,
+*  256  (Լ127ms,  AUTO_RESET_PERIOD). ѭ:
+*   1. ֵ ->  (ѹֵ 1.5V)
+*   2. ȥֵ + Hann  + 256 FFT -> 100/120Hz ķֵ
+*   3. ˸ = ֵ / ֵ, Ϊƹ, Ϊչ
+* ֻ"չ"Ź, ƻʱչƴ򿪲ƭ.
+* ʱλǰϴη˶, , ڲλ;
+* ֻ (ûЧ¼) һͲ.
+*
+* FFT  CMSIS-DSP  arm_cfft_radix4_f32 (鲿0). arm_rfft_fast_f32 Ҫ
+* arm_bitreversal_32 ļڹ, arm_rfft_f32 ֲ֧ 256 .
+*************************************************************************/
+
+#define LIGHT_BURST_LEN        256
+#define LIGHT_DECIMATION       2
+#define LIGHT_FS_HZ            (2000000.0f / (4 * 124) / LIGHT_DECIMATION)
+#define LIGHT_PERIOD_TICKS     5000          //  500ms (100us tick)
+
+#define LIGHT_DARK_LEVEL       1861          // 1.5V @ 3.3V/4095
+#define LIGHT_LEVEL_HYST       60            // лز
+
+#define LIGHT_FLICKER_F_LO     85.0f         //  100Hz(50Hz)  120Hz(60Hz)
+#define LIGHT_FLICKER_F_HI     135.0f
+#define LIGHT_FLICKER_ON       0.04f         // ˸ >4% Ϊƹ
+#define LIGHT_FLICKER_OFF      0.02f         // <2% ָΪչ
+
+#define LIGHT_FFT_BUDGET_CYCLES 48000        // ̨Ԥ, 16MHz  3ms
+
+enum { BURST_IDLE = 0, BURST_CAPTURE, BURST_READY };
+
+static __IO uint16_t burst_buf[LIGHT_BURST_LEN];
+static __IO uint16_t burst_idx = 0;
+static __IO uint8_t  burst_state = BURST_IDLE;
+static uint8_t burst_decim = 0;
+
+static Light_Class_t light_class = LIGHT_DARK;
+static uint32_t light_last_tick = 0;
+static uint8_t  light_first_run = 1;
+static uint32_t fft_last_cycles = 0;
+static uint32_t fft_max_cycles = 0;
+
+#if LIGHT_FLICKER_ENABLE
+static float32_t fft_buf[2 * LIGHT_BURST_LEN];   // ֯ re,im
+static float32_t hann_win[LIGHT_BURST_LEN];
+static arm_cfft_radix4_instance_f32 fft_inst;
+#endif
+
+static const char *Light_Class_Name(Light_Class_t c)
+{
+    switch (c)
+    {
+        case LIGHT_DAYLIGHT:   return "daylight";
+        case LIGHT_ARTIFICIAL: return "artificial";
+        default:               return "dark";
+    }
+}
+
+void Light_Init(uint8_t is_hot_start)
+{
+#if LIGHT_FLICKER_ENABLE
+    for (int i = 0; i < LIGHT_BURST_LEN; i++)
+    {
+        hann_win[i] = 0.5f - 0.5f * arm_cos_f32(2.0f * PI * i / (LIGHT_BURST_LEN - 1));
+    }
+    arm_cfft_radix4_init_f32(&fft_inst, LIGHT_BURST_LEN, 0, 1);
+#endif
+
+    // ָϴη, ֹλ̵; ϴηʱҲ
+    if (is_hot_start && PersistData.light.valid)
+    {
+        light_class = (Light_Class_t)PersistData.light.light_class;
+        if (light_class > LIGHT_ARTIFICIAL) light_class = LIGHT_DARK;
+        light_last_tick = HAL_GetTick() - PersistData.light.since_last;
+        light_first_run = 0;
+    }
+    else
+    {
+        light_class = LIGHT_DARK;
+        light_first_run = 1;
+    }
+
+    burst_state = BURST_IDLE;
+}
+
+/**
+  * @brief λǰ. ɵһͻ, λѵ²
+  */
+void Light_Save(void)
+{
+    uint32_t since = HAL_GetTick() - light_last_tick;
+
+    if (light_first_run || since > LIGHT_PERIOD_TICKS) since = LIGHT_PERIOD_TICKS;
+    PersistData.light.since_last = (uint16_t)since;
+    PersistData.light.light_class = (uint8_t)light_class;
+    PersistData.light.valid = 1;
+    Persist_MarkDirty(PERSIST_REC_LIGHT);
+}
+
+void Light_Sample(uint16_t sample)
+{
+    if (burst_state != BURST_CAPTURE) return;
+
+    if (++burst_decim < LIGHT_DECIMATION) return;
+    burst_decim = 0;
+
+    burst_buf[burst_idx++] = sample;
+    if (burst_idx >= LIGHT_BURST_LEN)
+    {
+        burst_state = BURST_READY;
+    }
+}
+
+/**
+  * @brief һͻ, ·
+  */
+static void Light_Analyse(void)
+{
+    uint32_t t0 = DWT_CYCCNT_GET();
+    uint32_t sum = 0;
+    float32_t mean;
+    Light_Class_t new_class;
+    uint8_t bright;
+    uint32_t flicker_permille = 0;
+
+    for (int i = 0; i < LIGHT_BURST_LEN; i++)
+    {
+        sum += burst_buf[i];
+    }
+    mean = (float32_t)sum / LIGHT_BURST_LEN;
+
+    /* 1.  (ز) */
+    if (light_class == LIGHT_DARK)
+        bright = (mean > LIGHT_DARK_LEVEL + LIGHT_LEVEL_HYST);
+    else
+        bright = (mean >= LIGHT_DARK_LEVEL - LIGHT_LEVEL_HYST);
+
+    if (!bright)
+        new_class = LIGHT_DARK;
+    else
+        new_class = (light_class == LIGHT_DARK) ? LIGHT_DAYLIGHT : light_class;
+
+#if LIGHT_FLICKER_ENABLE
+    /* 2. ʱſ˸ */
+    if (new_class != LIGHT_DARK)
+    {
+        int k_lo = (int)(LIGHT_FLICKER_F_LO * LIGHT_BURST_LEN / LIGHT_FS_HZ);
+        int k_hi = (int)(LIGHT_FLICKER_F_HI * LIGHT_BURST_LEN / LIGHT_FS_HZ) + 1;
+        float32_t peak = 0.0f, depth;
+
+        for (int i = 0; i < LIGHT_BURST_LEN; i++)
+        {
+            fft_buf[2 * i]     = ((float32_t)burst_buf[i] - mean) * hann_win[i];
+            fft_buf[2 * i + 1] = 0.0f;
+        }
+
+        arm_cfft_radix4_f32(&fft_inst, fft_buf);
+
+        for (int k = k_lo; k <= k_hi; k++)
+        {
+            float32_t re = fft_buf[2 * k], im = fft_buf[2 * k + 1];
+            float32_t p = re * re + im * im;
+            if (p > peak) peak = p;
+        }
+
+        // ҷ = 2|X|/(N*0.5), Hann  0.5
+        depth = 4.0f * sqrtf(peak) / LIGHT_BURST_LEN / mean;
+        flicker_permille = (uint32_t)(depth * 1000.0f);
+
+        if (depth > LIGHT_FLICKER_ON)
+            new_class = LIGHT_ARTIFICIAL;
+        else if (depth < LIGHT_FLICKER_OFF)
+            new_class = LIGHT_DAYLIGHT;   // زڱԭ
+    }
+#endif
+
+    fft_last_cycles = DWT_CYCCNT_GET() - t0;
+    if (fft_last_cycles > fft_max_cycles) fft_max_cycles = fft_last_cycles;
+
+    if (new_class != light_class || fft_last_cycles > LIGHT_FFT_BUDGET_CYCLES)
+    {
+        printf("\r\n [Light] %s, level=%d, flicker=%d.%d%%, analyse=%u cyc (%u us, max %u, budget %u)%s",
+               Light_Class_Name(new_class), (int)mean,
+               (int)(flicker_permille / 10), (int)(flicker_permille % 10),
+               fft_last_cycles, DWT_Cycle_To_Us(fft_last_cycles), fft_max_cycles,
+               (uint32_t)LIGHT_FFT_BUDGET_CYCLES,
+               (fft_last_cycles > LIGHT_FFT_BUDGET_CYCLES) ? " OVER BUDGET" : "");
+    }
+
+    light_class = new_class;
+}
+
+void Light_Task(void)
+{
+    if (burst_state == BURST_IDLE)
+    {
+        if (light_first_run || HAL_GetTick() - light_last_tick >= LIGHT_PERIOD_TICKS)
+        {
+            light_first_run = 0;
+            burst_idx = 0;
+            burst_decim = 0;
+            burst_state = BURST_CAPTURE;
+        }
+    }
+    else if (burst_state == BURST_READY)
+    {
+        Light_Analyse();
+        light_last_tick = HAL_GetTick();
+        burst_state = BURST_IDLE;
+    }
+}
+
+Light_Class_t Light_GetClass(void)
+{
+    return light_class;
+}
+
+uint8_t Light_NeedLamp(void)
+{
+    return (light_class != LIGHT_DAYLIGHT);
+}
+
+void Light_GetFftStats(uint32_t *last_cycles, uint32_t *max_cycles)
+{
+    *last_cycles = fft_last_cycles;
+    *max_cycles = fft_max_cycles;
+}
@@ -0,0 +1,294 @@
+#include "lockout.h"
+#include "persist.h"
+#include "kv_store.h"
+#include "rtc.h"
+#include "dwt.h"
+#include "string.h"
+#include "stdio.h"
+
+/************************************************************************
+* ƽ: ʧܼ + ָ˱
+*
+* ԭֻǱ 2 , ʱλҲû, Բͣ. :
+*
+*  Դ: ÿң (NEC ʶ) һ,  4 , ͬһң
+*  LOCK_FAILS ξ, ڼİڽ϶, ״̬,
+*  κУ. ȫһ (0 ) Դ,  LOCK_GLOBAL_FAILS
+*  ȫ, ңʶƲȥ. һԴȫֵļ.
+*
+*  ˱: һ LOCK_BASE_S, ÿһη,  LOCK_MAX_S.
+*
+*  λ: ʣʱڱSRAM (PersistData.lock), ʱÿһ
+*  һ, ʱλ/Źλ, λļ벻.
+*
+*  ϵ: ȫʱдһ Flash ¼ (KV_KEY_LOCKOUT), ڵʱ.
+*  ʱӻ߾Ͱʣ; ʱûʹͷһ, ε
+*  ֻ. ɾ¼. ңļϵ.
+*
+*  ȫʱŽøɻ, ѭĩβ WFI,  SysTick (100us) ж
+*  , ˯ʱ slept_ms.
+*************************************************************************/
+
+#define LOCK_TICKS_PER_S   10000u    // HAL tick 100us
+
+typedef char lock_persist_check[(sizeof(PersistData.lock.remain) / 4 == LOCK_SRC_NUM) ? 1 : -1];
+
+/* Flash ȫ¼ */
+typedef struct
+{
+    uint32_t until;           // ڵ RTC_Now , 0: ʱʱû
+    uint32_t duration_s;      // 
+    uint8_t  level;
+    uint8_t  reserved[3];
+} Lock_Flash_t;
+
+static uint32_t lock_tick;          // ϴεʱʱ
+static uint32_t lock_sleep_cycles;  //  1ms ˯
+
+
+static uint32_t Lockout_Duration_S(uint8_t level)
+{
+    uint32_t s = LOCK_BASE_S;
+
+    while (level-- && s < LOCK_MAX_S) s <<= 1;
+    return (s > LOCK_MAX_S) ? LOCK_MAX_S : s;
+}
+
+// ңеĸ, ûз LOCK_SRC_GLOBAL
+static uint8_t Lockout_Find(uint8_t remote_id)
+{
+    Persist_Lock_t *lk = &PersistData.lock;
+
+    for (uint8_t i = 1; i < LOCK_SRC_NUM; i++)
+    {
+        if ((lk->used & (1u << i)) && lk->id[i] == remote_id) return i;
+    }
+    return LOCK_SRC_GLOBAL;
+}
+
+// ңӦĸ, ûоռһ; ˻ûٵ
+static uint8_t Lockout_Slot(uint8_t remote_id)
+{
+    Persist_Lock_t *lk = &PersistData.lock;
+    uint8_t victim = Lockout_Find(remote_id);
+
+    if (victim != LOCK_SRC_GLOBAL) return victim;
+    for (uint8_t i = 1; i < LOCK_SRC_NUM; i++)
+    {
+        if (!(lk->used & (1u << i)))
+        {
+            victim = i;
+            break;
+        }
+        if (lk->remain[i] == 0 && (victim == 0 || lk->fails[i] < lk->fails[victim])) victim = i;
+    }
+    if (victim == 0) return LOCK_SRC_GLOBAL;   // ȫ, ֻȫּ
+
+    lk->used |= 1u << victim;
+    lk->id[victim] = remote_id;
+    lk->fails[victim] = 0;
+    lk->level[victim] = 0;
+    lk->remain[victim] = 0;
+    return victim;
+}
+
+static uint32_t Lockout_Engage(uint8_t n)
+{
+    Persist_Lock_t *lk = &PersistData.lock;
+    uint32_t s = Lockout_Duration_S(lk->level[n]);
+
+    lk->remain[n] = s * LOCK_TICKS_PER_S;
+    if (lk->level[n] < 16) lk->level[n]++;
+    lk->fails[n] = 0;
+    lk->lockouts++;
+
+    if (n == LOCK_SRC_GLOBAL)
+    {
+        Lock_Flash_t f;
+        uint32_t now = RTC_Now();
+
+        memset(&f, 0, sizeof(f));
+        f.until = now ? now + s : 0;
+        f.duration_s = s;
+        f.level = lk->level[n];
+        KV_Set(KV_KEY_LOCKOUT, &f, sizeof(f));
+    }
+    return s;
+}
+
+void Lockout_Init(uint8_t is_hot_start)
+{
+    Persist_Lock_t *lk = &PersistData.lock;
+    Lock_Flash_t f;
+
+    lock_tick = HAL_GetTick();
+    lock_sleep_cycles = 0;
+
+    if (is_hot_start && (lk->used & 1u)) return;   // SRAM ľµ
+
+    //  (ûм¼): ָֻ Flash ȫ
+    memset(lk, 0, sizeof(*lk));
+    lk->used = 1u;
+    if (KV_Get(KV_KEY_LOCKOUT, &f, sizeof(f)) == sizeof(f))
+    {
+        uint32_t now = RTC_Now();
+        uint32_t s = f.duration_s;
+
+        if (f.until && now)
+            s = (f.until > now) ? f.until - now : 0;
+        if (s > LOCK_MAX_S) s = LOCK_MAX_S;
+
+        lk->remain[LOCK_SRC_GLOBAL] = s * LOCK_TICKS_PER_S;
+        lk->level[LOCK_SRC_GLOBAL] = f.level;
+        if (s == 0) KV_Delete(KV_KEY_LOCKOUT);
+    }
+    Persist_MarkDirty(PERSIST_REC_LOCK);
+}
+
+uint8_t Lockout_Blocked(uint8_t remote_id)
+{
+    Persist_Lock_t *lk = &PersistData.lock;
+    uint8_t blocked = (lk->remain[LOCK_SRC_GLOBAL] != 0);
+
+    for (uint8_t i = 1; i < LOCK_SRC_NUM && !blocked; i++)
+    {
+        if ((lk->used & (1u << i)) && lk->id[i] == remote_id && lk->remain[i]) blocked = 1;
+    }
+    if (blocked)
+    {
+        lk->rejected++;
+        Persist_MarkDirty(PERSIST_REC_LOCK);
+    }
+    return blocked;
+}
+
+uint32_t Lockout_Fail(uint8_t remote_id)
+{
+    Persist_Lock_t *lk = &PersistData.lock;
+    uint8_t n = Lockout_Slot(remote_id);
+    uint32_t s = 0, g;
+
+    if (n != LOCK_SRC_GLOBAL && ++lk->fails[n] >= LOCK_FAILS) s = Lockout_Engage(n);
+    if (++lk->fails[LOCK_SRC_GLOBAL] >= LOCK_GLOBAL_FAILS)
+    {
+        g = Lockout_Engage(LOCK_SRC_GLOBAL);
+        if (g > s) s = g;
+    }
+    Persist_MarkDirty(PERSIST_REC_LOCK);
+    return s;
+}
+
+// ֻеĸ: ڱңռ, ðѱԴ () ļ
+void Lockout_Success(uint8_t remote_id)
+{
+    Persist_Lock_t *lk = &PersistData.lock;
+    uint8_t n = Lockout_Find(remote_id);
+
+    if (n != LOCK_SRC_GLOBAL)
+    {
+        lk->fails[n] = 0;
+        lk->level[n] = 0;
+    }
+    lk->fails[LOCK_SRC_GLOBAL] = 0;
+    lk->level[LOCK_SRC_GLOBAL] = 0;
+    Persist_MarkDirty(PERSIST_REC_LOCK);
+}
+
+void Lockout_Task(void)
+{
+    Persist_Lock_t *lk = &PersistData.lock;
+    uint32_t now = HAL_GetTick();
+    uint32_t dt = now - lock_tick;
+
+    if (dt == 0) return;
+    lock_tick = now;
+
+    for (uint8_t i = 0; i < LOCK_SRC_NUM; i++)
+    {
+        uint32_t r = lk->remain[i];
+        if (r == 0) continue;
+
+        lk->remain[i] = (r > dt) ? r - dt : 0;
+        if (lk->remain[i] / LOCK_TICKS_PER_S != r / LOCK_TICKS_PER_S || lk->remain[i] == 0)
+        {
+            Persist_MarkDirty(PERSIST_REC_LOCK);   // ÿһһ
+        }
+        if (lk->remain[i] == 0)
+        {
+            if (i == LOCK_SRC_GLOBAL)
+            {
+                printf("\r\n [Lock] Keypad unlocked.");
+                KV_Delete(KV_KEY_LOCKOUT);
+            }
+            else
+            {
+                printf("\r\n [Lock] Remote 0x%02X unlocked.", lk->id[i]);
+            }
+        }
+    }
+}
+
+// ʱλǰ: ʱ², һύд
+void Lockout_Save(void)
+{
+    Lockout_Task();
+    Persist_MarkDirty(PERSIST_REC_LOCK);
+}
+
+uint8_t Lockout_Global(void)
+{
+    return PersistData.lock.remain[LOCK_SRC_GLOBAL] != 0;
+}
+
+void Lockout_Sleep(void)
+{
+    uint32_t t0, ms;
+
+    if (!Lockout_Global()) return;
+
+    t0 = DWT_CYCCNT_GET();
+    __WFI();
+    lock_sleep_cycles += DWT_CYCCNT_GET() - t0;
+
+    ms = lock_sleep_cycles / (SystemCoreClock / 1000);
+    if (ms)
+    {
+        lock_sleep_cycles -= ms * (SystemCoreClock / 1000);
+        PersistData.lock.slept_ms += ms;   // 浹ʱÿıһύ
+    }
+}
+
+void Lockout_GetStats(Lock_Stats_t *st)
+{
+    const Persist_Lock_t *lk = &PersistData.lock;
+
+    memset(st, 0, sizeof(*st));
+    st->remain_s = (lk->remain[LOCK_SRC_GLOBAL] + LOCK_TICKS_PER_S - 1) / LOCK_TICKS_PER_S;
+    st->fails = lk->fails[LOCK_SRC_GLOBAL];
+    st->level = lk->level[LOCK_SRC_GLOBAL];
+    for (uint8_t i = 1; i < LOCK_SRC_NUM; i++)
+    {
+        if (!(lk->used & (1u << i))) continue;
+        st->sources++;
+        if (lk->remain[i]) st->sources_locked++;
+    }
+    st->lockouts = lk->lockouts;
+    st->rejected = lk->rejected;
+    st->slept_ms = lk->slept_ms;
+}
+
+void Lockout_Report(void)
+{
+    const Persist_Lock_t *lk = &PersistData.lock;
+    Lock_Stats_t st;
+
+    Lockout_GetStats(&st);
+    printf("\r\n [Lock] global: %u fails, level %u, %u s left; %u lockouts, %u keys rejected, slept %u ms",
+           st.fails, st.level, st.remain_s, st.lockouts, st.rejected, st.slept_ms);
+    for (uint8_t i = 1; i < LOCK_SRC_NUM; i++)
+    {
+        if (!(lk->used & (1u << i))) continue;
+        printf("\r\n [Lock] remote 0x%02X: %u fails, level %u, %u s left", lk->id[i],
+               lk->fails[i], lk->level[i], (lk->remain[i] + LOCK_TICKS_PER_S - 1) / LOCK_TICKS_PER_S);
+    }
+}
@@ -45,6 +45,30 @@
 #include "dma.h"
 #include "string.h"
 #include "core_cm4.h"
+#include "presence.h"
+#include "light_ctrl.h"
+#include "dwt.h"
+#include "servo.h"
+#include "obstruct.h"
+#include "persist.h"
+#include "crc.h"
+#include "rng.h"
+#include "entropy.h"
+#include "kv_store.h"
+#include "cred_store.h"
+#include "pwd_hash.h"
+#include "ct_compare.h"
+#include "visitor.h"
+#include "lockout.h"
+#include "ir_keymap.h"
+#include "ir_capture.h"
+#include "door_fsm.h"
+#include "access_log.h"
+#include "access_rule.h"
+#include "rtc.h"
+#include "boot_prof.h"
+#include "fault.h"
+#include "supervisor.h"
 
 #define RELAY_PORT GPIOG
 #define RELAY_PIN  GPIO_PIN_8
@@ -53,21 +77,10 @@
 #define PASSWORD_LEN 8
 #define DISP_LEN	 	 8
 #define SEG_STAR 		 0x40
-#define SERVO_CLOSE  600
-#define SERVO_OPEN   2400
 #define AUTO_RESET_PERIOD_MS (2*1000) //Զλ
 #define FLOW_TOKEN_VALID 0x96A53C21  //ħ
-
-/* ݱݺ */
-#define BKP_MAGIC_NUMBER  0xA5A5  // ǷЧħ
-#define BKP_REG_MAGIC      RTC->BKP0R // reg0ħ
-#define BKP_REG_PWD_1      RTC->BKP1R // reg1ǰλ
-#define BKP_REG_PWD_2      RTC->BKP2R // reg2λ
-#define BKP_REG_STATE      RTC->BKP3R // ϵͳ״̬
-
-#define BKP_REG_IDX      RTC->BKP4R  // ˼λinput_index 
-#define BKP_REG_INBUF_1  RTC->BKP5R  // input_buf ǰ4
-#define BKP_REG_INBUF_2  RTC->BKP6R  // input_buf 4
+#define VERIFY_JITTER_MIN    50          //Уǰʱ 5~20ms (100us tick)
+#define VERIFY_JITTER_MAX    200
 
 /* USER CODE END Includes */
 
@@ -75,9 +88,9 @@
 
 /* USER CODE BEGIN PV */
 /* Private variables ---------------------------------------------------------*/
-__IO uint32_t GlobalTimingDelay100us;
-uint16_t adc_raw_data[4];
+uint16_t adc_raw_data[ADC_SEQ_LEN];
 __IO uint32_t FlowSafetyToken = 0; //ȫ
+uint8_t SysHotStart = 0;           //Ƿ
 /* USER CODE END PV */
 
 /* USER CODE BEGIN PV */
@@ -91,31 +104,42 @@ void MX_IWDG_Init(void);   // 
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 void Seg_Display(uint8_t *buf);
-void Password_Input(uint8_t num);
+void Seg_Release(void);
+void Password_Show(void);
 uint8_t Password_Check(void);
+uint32_t Password_Verify(void);
 void Seg_Show_OPEN(void);
 void Seg_Show_Err(void);
+void Seg_Show_Ready(void);
 void Password_Reset(void);
-void Password_Delete(void);
-void Servo_Set(uint16_t pwm);
+void Password_Clear(void);
 void LED_All_Off(void);
 void LED_All_On(void);
 void Turn_On_LED(uint8_t LED_NUM);
+uint8_t LED_Get_Mask(void);
+void LED_Set_Mask(uint8_t mask);
 void Buzzer_Tone(uint32_t tone_delay, uint32_t duration_ms);
 void Buzzer_Play_Melody(void);
 void Relay_Init_GPIO(void);
 void Relay_Control(uint8_t state);
 
 /* USER CODE BEGIN PFP */
+void SysData_Early_Init(void);// ж/, رSRAM, Ȱ
 void SysData_Init(void);      // ʼϵͳݣָã
-void SysData_Save_PWD(void);  // ֻ
+void Checkpoint_Save(void);   // ʱλǰͼʱ
+void Checkpoint_Restore(void);// ʱ LED
 void SysData_Save_State(void);// ֻ״̬
 void System_Restore_Hardware(void); // ݻָ״̬Ӳ
 void SysData_Save_Input(void);     
 void SysData_Restore_Input(void);
-uint8_t Password_Check_Algorithm_A(void); // 㷨AXOR
-uint8_t Password_Check_Algorithm_B(void); // 㷨B
+uint8_t Password_Check_Algorithm_A(const uint8_t *digest); // 㷨AXOR
+uint8_t Password_Check_Algorithm_B(const uint8_t *digest); // 㷨B
 uint8_t SysData_Validate(void); // У
+void Console_Poll(void);        // 
+void Rng_Report(void);          // سȺͲ
+void IR_Report(void);           // ⰴкͶ
+void Boot_Deferred(void);       // һѭ֮: ˢ, Ϣ
+void Boot_Report(void);         // Ϣ͸ģͳ (,  'B')
 
 
 /* USER CODE END PFP */
@@ -146,7 +170,7 @@ const uint8_t SEG_CODE_TABLE[16] =
 
 typedef struct
 {
-    uint8_t password[PASSWORD_LEN]; // 8ֽ
+    Pwd_Hash_t pwd;                 // κժҪ, 
 } SystemData_t;
 
 // ȫʵ
@@ -156,27 +180,40 @@ SystemData_t sysData;
 const uint8_t DEFAULT_PASSWORD[PASSWORD_LEN] = {1,2,3,4,5,6,7,8};
 
 
-typedef enum
-{
-    SYS_IDLE = 0,        // 
-    SYS_INPUT_PWD,       // ing
-    SYS_VERIFY,          // ֤
-    SYS_OPEN,            // ing
-    SYS_ERROR            // 
-} SystemState_t;
+/* Ž״̬, 뻺͸μʱ (door_fsm.c) */
+Door_Fsm_t door;
+typedef char door_len_check[(PASSWORD_LEN == DOOR_PWD_LEN && DISP_LEN == DOOR_PWD_LEN &&
+                             KEY_DEL == DOOR_KEY_DEL) ? 1 : -1];
 
-SystemState_t SysState = SYS_IDLE;
-
-/*  */
-uint8_t input_buf[DISP_LEN] = {14, 14, 14, 14, 14, 14, 14, 14};  //ʼȫ
-uint8_t input_index = 0;
 uint8_t display_buf[PASSWORD_LEN] = {0};
 
-uint32_t open_tick = 0;
-uint32_t err_tick = 0;
 uint32_t led_tick = 0;
 uint8_t led_count = 0;
 
+/* ܵǰ (), ûͲд I2C */
+static uint8_t seg_shadow[8];
+static uint8_t seg_shadow_valid = 0;
+
+/*  */
+static uint32_t boot_cycles = 0;      // ϵһ DWT , DWT_Cycle_Init ֮ǰ
+static uint8_t  sys_restored = 0;     // SRAMЧ
+static uint8_t  ckpt_resume = 0;      // ɶʱλ
+static uint32_t ckpt_gap_cycles = 0;  // λǰһ -> DWT_Cycle_Init , ټӵǰ CYCCNT Ǹλ󾭹
+static uint32_t ckpt_output_us = 0;   // λ -> LED/̵ָ
+static uint32_t ckpt_resume_us = 0;   // λ -> ʾ//ʱȫ
+
+/* ڼֻ, һѭ֮д (ZLG7290 ÿֽҪ 0.5ms) */
+static uint8_t seg_hold = 1;
+static uint8_t seg_next[8];
+static uint8_t seg_next_valid = 0;
+static uint8_t boot_deferred = 0;
+static uint8_t trace_state = 0xFF;    // ϴμٻ״̬
+
+static uint32_t Entropy_Clock(void)
+{
+    return DWT_CYCCNT_GET();
+}
+
 /* USER CODE END 0 */
 
 
@@ -184,71 +221,256 @@ int main(void)
 {
   /* MCU Configuration----------------------------------------------------------*/
 
+  boot_cycles = DWT_CYCCNT_GET();   // ϵͳλ CYCCNT, 㸴λ˶
+  DWT_Cycle_Init();                 // , ׶ʱ
+
   /* Reset of all peripherals, Initializes the Flash interface and the Systick. */
   HAL_Init();
 
   /* Configure the system clock */
   SystemClock_Config();
+  BootProf_Mark(BOOT_STAGE_CLOCK);
 
   /* Initialize all configured peripherals */
   // ʼ裬ʱӲӲ޷
   MX_GPIO_Init();
   
-  // ؼ޸GPIO Initصƣֹϵ˸
-  // ȷLEDǵ͵ƽǸߵƽöӦOff
-  LED_All_On(); 
+  // ؼ޸GPIO InitLEDֹϵ˸
+  // ʱλļЧֱӻָλǰ LED/̵, ȫʾ
+  MX_CRC_Init();               // SRAMУҪ
+  SysData_Early_Init();
+  Fault_Init();                // ֳ͸ٻڱSRAM, Ҫ Persist_Init ֮
+  Fault_Trace(FAULT_TRC_BOOT, SysHotStart);
+  BootProf_Mark(BOOT_STAGE_OUTPUT);
 	
+  MX_DMA_Init();                // ȿ DMA ʱ,  USART1/TIM7  MspInit Ҫ DMA
+  BootProf_Mark(BOOT_STAGE_DMA);
   MX_TIM12_Init();
+  BootProf_Mark(BOOT_STAGE_TIM12);
   MX_I2C1_Init();
+  BootProf_Mark(BOOT_STAGE_I2C1);
   MX_USART1_UART_Init();
+  BootProf_Mark(BOOT_STAGE_USART1);
+  MX_TIM7_Init();
+  BootProf_Mark(BOOT_STAGE_TIM7);
+  MX_ADC3_Init();
+  BootProf_Mark(BOOT_STAGE_ADC3);
+  MX_RNG_Init();
+  Entropy_Init(RNG_Refill, Entropy_Clock, DWT_CYCCNT_GET() ^ SysTick->VAL);   // ж, ȡ
+  BootProf_Mark(BOOT_STAGE_RNG);
+  KV_Init();                   // Flash ֵ: زؽ, /ôȡ
+  Cred_Init();                 // ûӼֵ RAM
+  Visitor_Init();              // ÿ TOTP Կ, Ԥ HMAC м״̬
+  Keymap_Init();               // λϣ, ûѧóĬ
+  BootProf_Mark(BOOT_STAGE_KV);
+  MX_RTC_Init();               // LSE , λǰѾ߾Ͳٳʼ
+  BootProf_Mark(BOOT_STAGE_RTC);
+  Rule_Init();                 // ʱιչλͼ
+  Lockout_Init(SysHotStart);   // : , ȡ Flash ȫ
+  BootProf_Mark(BOOT_STAGE_RULE);
 	
 
 
   // ߼ȳʼӲ(Ĭ״̬)ٻָݲӲ״̬
   // System_Restore_Hardware ѵ/ŸĻȷ״̬
   SysData_Init(); 
+  BootProf_Mark(BOOT_STAGE_RESTORE);
+  
+  // ջ (TIM12 ж) + ˶ (TIM7 DMA), Ӹλǰλý
+  Servo_Init(SysHotStart);
+  Obstruct_Init();             // ת,  TIM12 жֱӷ
+  if (ckpt_resume)
+  {
+      ckpt_resume_us = DWT_Cycle_To_Us(ckpt_gap_cycles + DWT_CYCCNT_GET());
+  }
+  BootProf_Mark(BOOT_STAGE_SERVO);
 	
+  // : ָ, Ȼ ADC3 ѭDMA
+  Presence_Init(SysHotStart);
+  Light_Init(SysHotStart);
+  BootProf_Mark(BOOT_STAGE_SENSE);
+  
+  // ־: λ Flash дָ, 鱸SRAMݴ
+  AccessLog_Init();
+  if (!SysHotStart)
+  {
+      AccessLog_Append(LOG_EVT_POWER_ON, 0, LOG_OUT_NONE, (uint8_t)door.state);
+  }
+  HAL_ADC_Start_DMA(&hadc3, (uint32_t *)adc_raw_data, ADC_SEQ_LEN);
+  __HAL_DMA_DISABLE_IT(&hdma_adc3, DMA_IT_HT); // ֻж, 봫жû
+  BootProf_Mark(BOOT_STAGE_LOG);
+  
+  // 󳵻բǰ, ֻʾ (ڼֻ, һѭд)
+  if (door.state == SYS_IDLE && Presence_IsVehicle())
+  {
+      Seg_Show_Ready();
+  }
+
   // ʼŹ
   MX_IWDG_Init();
   HAL_IWDG_Refresh(&hiwdg);
+  Supervisor_Init(SysHotStart);   // Ժֻиʱι
+  BootProf_Mark(BOOT_STAGE_IWDG);
   
   /* USER CODE BEGIN 2 */
-  // ʱӡȫ޸У԰Щprintfŵ SysData_Init ֧
-  printf("\n\r=================================================");
-  printf("\n\r        STM32F407 ˽ҳϵͳ       ");
-  printf("\n\r=================================================");
-  printf("\n\r [] ǰ: ");
-  for(int i=0;i<8;i++) printf("%d", sysData.password[i]);
-  printf("\n\r [ϵͳܾ]");
-  printf("\n\r 1.  Ž: ʹúң");
-  printf("\n\r    - : 0-9, CH-ɾ");
-  printf("\n\r-------------------------------------------------");
-  printf("\n\r ϵͳʼɣ... \n\r");
+  // ϢҪһٶ (), Ų Boot_Deferred, һѭ֮ٴ
   /* USER CODE END 2 */
 
   while (1)
   {
-      HAL_IWDG_Refresh(&hiwdg);
+      Supervisor_Check();
     
-      if (HAL_GetTick() > AUTO_RESET_PERIOD_MS)
+      // ־/ץڼ䲻λ, ˵; պҲһ (ٵһ);
+      // סȳ ( 0.8s), Ȼ held 渴λ, Զղ.
+      // Уʱ ( 20ms) Ҳܱλ, Ե밴ջУ, .
+      // ѧϰңҪ 11 , ѧϰ״ֻ̬ RAM , ѧ ( 30s û) ٸλ
+      if (HAL_GetTick() > AUTO_RESET_PERIOD_MS && !AccessLog_Dumping() && !IR_Capture_Busy() &&
+          door.state != SYS_VERIFY && !Keymap_Learning() && !Remote_Infrared_Holding() &&
+          (!Remote_Infrared_Busy() || HAL_GetTick() > 2 * AUTO_RESET_PERIOD_MS))
       {
-          printf("\r\n [Safety] Scheduled Maintenance Reset triggered...");
+          // 1. λǰӡ (, ÿ 200ms һ̫), ֻڷķ.
+          //    дͿŹͳڱSRAM縴λۼ,  'B' 
+          while ((USART1->SR & 0x40) == 0);
           
-          // 1. ǿƱȫؼ
-          SysData_Save_State();
+          // 2. ǿƱȫؼ: ȸԱ, ״̬һύ
           SysData_Save_Input();
-          
-          // 2. ʱȷӡԼдȶ
-          HAL_Delay(100); 
+          Presence_Save();
+          Light_Save();
+          Servo_Save();
+          Checkpoint_Save();
+          Lockout_Save();
+          SysData_Save_State();
           
           // 3. ִиλ
           NVIC_SystemReset(); 
       }
 
-      uint8_t key;
-      key = Remote_Infrared_KeyDeCode();
+      // һȡһ¼, ûȡڶһȡ; ظ¼
+      IR_Key_Event_t kev;
+      uint8_t key = 0xFF;
+      uint8_t key_long = 0xFF;
+      if (Remote_Infrared_GetKey(&kev))
+      {
+          if (kev.type == IR_KEY_PRESS)
+          {
+              key = kev.key;
+              Fault_Trace(FAULT_TRC_KEY, key);
+          }
+          else if (kev.type == IR_KEY_LONG)
+          {
+              key_long = kev.key;
+          }
+      }
+      
+      // ең (ȫ): ֱӶ, ״̬, У
+      Lockout_Task();
+      Keymap_Task();
+      IR_Capture_Task();
+      if ((key != 0xFF || key_long != 0xFF) && Lockout_Blocked(kev.remote_id))
+      {
+          key = 0xFF;
+          key_long = 0xFF;
+      }
+      
+      Presence_Event_t presence = Presence_GetEvent();
+      if (presence != PRESENCE_EVT_NONE) Fault_Trace(FAULT_TRC_PRESENCE, presence);
+      
+      // ̨: ط (ͻ˲FFT)
+      Light_Task();
+      Relay_Control(Light_NeedLamp());
+      
+      // ɢĶ, ƵʱͳһдSRAM
+      Persist_Task();
+      
+      // ־: ݴ湻һд Flash (ֻڿʱ), ʱƽ DMA
+      AccessLog_Task(door.state == SYS_IDLE && !Presence_IsVehicle());
+      
+      // : LSE  RTC (ֻҪ)
+      RTC_Task();
+      
+      // : ־ / Уʱ
+      Console_Poll();
+      
+      // 
+      Servo_Event_t servo_evt = Servo_GetEvent();
+      if (servo_evt != SERVO_EVT_NONE) Fault_Trace(FAULT_TRC_SERVO, servo_evt);
+      if (servo_evt == SERVO_EVT_OBSTRUCTED)
+      {
+          // жѾ/ͣס, ¼л״̬
+          Obstruct_Report_t rep;
+          Obstruct_GetReport(&rep);
+          printf("\r\n [Safety] Obstruction while %s: %d mA, detected in %u us / %d periods (max %u, bound %u)%s, %s",
+                 (rep.dir < 0) ? "closing" : "opening", rep.current_ma,
+                 rep.latency_us, rep.periods, rep.max_latency_us, rep.bound_us,
+                 rep.over_bound ? " OVER BOUND" : "",
+                 (rep.dir < 0) ? "reversed." : "stopped.");
+
+          AccessLog_Append(LOG_EVT_OBSTRUCT, 0,
+                           (rep.dir < 0) ? LOG_OUT_REVERSED : LOG_OUT_STOPPED, (uint8_t)door.state);
+
+          if (rep.dir < 0)
+          {
+              // բʱе: ¿, ȳٰͨԭ߼
+              FlowSafetyToken = FLOW_TOKEN_VALID;
+              Seg_Show_OPEN();
+              led_tick = HAL_GetTick();
+              led_count = 0;
+              Door_Enter(&door, SYS_OPEN, HAL_GetTick());
+          }
+          else
+          {
+              // բס: ͣԭ, شբ
+              FlowSafetyToken = 0;
+              Seg_Show_Err();
+              Door_Enter(&door, SYS_ERROR, HAL_GetTick());
+          }
+          SysData_Save_State(); //״̬˱
+      }
+      else if (servo_evt != SERVO_EVT_NONE)
+      {
+          Servo_Stats_t st;
+          Servo_GetStats(&st);
+          printf("\r\n [Servo] %s: target=%d pos=%d, %d ms (profile %d ms), isr wcet=%u cyc",
+                 (servo_evt == SERVO_EVT_SETTLED) ? "settled" :
+                 (servo_evt == SERVO_EVT_STALLED) ? "STALLED" : "TIMEOUT",
+                 st.target, st.position, st.move_periods * 20, st.profile_periods * 20,
+                 st.isr_max_cycles);
+      }
 
-      switch(SysState)
+      // ״̬ת door_fsm.c (߼, ģ), ŷصĶӲ
+      Door_Input_t din;
+      din.now = HAL_GetTick();
+      din.key = key;
+      din.key_long = key_long;
+      din.departed = (presence == PRESENCE_EVT_DEPARTED);
+      din.vehicle = Presence_IsVehicle();
+      uint32_t act = Door_Step(&door, &din);
+
+      if (act & DOOR_ACT_BEEP) Buzzer_Tone(2, 50);
+      if (act & DOOR_ACT_BEEP_LONG) Buzzer_Tone(2, 200);
+      if (act & DOOR_ACT_INPUT) Password_Show();
+      if (act & DOOR_ACT_VERIFY) act |= Password_Verify();
+      if (act & DOOR_ACT_CLOSE)
+      {
+          /* ͨ͹; ʱբгʱ */
+          if (din.departed)
+          {
+              printf("\r\n [Presence] Vehicle passed, closing.");
+          }
+          AccessLog_Append(LOG_EVT_CLOSE, 0, din.departed ? LOG_OUT_DEPARTED : LOG_OUT_TIMEOUT, SYS_OPEN);
+          FlowSafetyToken = 0;
+          Servo_Set(SERVO_CLOSE);
+          LED_All_Off();
+      }
+      if (act & DOOR_ACT_STATE)
+      {
+          // 8λ: ʱ, , ѭת
+          if (door.state == SYS_VERIFY)
+              door.verify_due += Entropy_Range(VERIFY_JITTER_MIN, VERIFY_JITTER_MAX);
+          SysData_Save_State(); //״̬˱
+      }
+
+      switch(door.state)
       {
         /* ==================  ================== */
         case SYS_IDLE:
@@ -259,13 +481,13 @@ int main(void)
             Servo_Set(SERVO_CLOSE);
             LED_All_Off();
           
-            if (key <= 9)
+            if (presence == PRESENCE_EVT_ARRIVED)
             {
+                // , Ѽ̽ʾ
+                printf("\r\n [Presence] Vehicle arrived.");
+                AccessLog_Append(LOG_EVT_ARRIVE, 0, LOG_OUT_NONE, (uint8_t)door.state);
+                Seg_Show_Ready();
                 Buzzer_Tone(2, 50);
-                Password_Reset();          // 
-                Password_Input(key);       // һλ
-                SysState = SYS_INPUT_PWD;
-                SysData_Save_State(); //״̬˱
             }
         }
         break;
@@ -274,50 +496,6 @@ int main(void)
         case SYS_INPUT_PWD:
         {
             FlowSafetyToken = 0;
-            if (key <= 9)
-            {
-                Password_Input(key);
-                Buzzer_Tone(2, 50);
-
-                /* 8λУ */
-                if (input_index >= PASSWORD_LEN)
-                {
-                    SysState = SYS_VERIFY;
-                    SysData_Save_State(); //״̬˱
-                } 
-            } else if (key == KEY_DEL) {
-                Buzzer_Tone(2, 50);
-                Password_Delete();
-            }
-        }
-        break;
-
-        /* ================== У ================== */
-        case SYS_VERIFY:
-        {
-            if (Password_Check())
-            {
-                FlowSafetyToken = FLOW_TOKEN_VALID;
-                Seg_Show_OPEN();           // OPEN
-                Buzzer_Play_Melody();
-              
-                open_tick = HAL_GetTick(); // ¼ʱ
-                led_tick = HAL_GetTick();
-                led_count = 0;
-                SysState = SYS_OPEN;
-                SysData_Save_State(); //״̬˱
-            }
-            else
-            {
-                FlowSafetyToken = 0;
-              
-                Seg_Show_Err();            // Err
-                Buzzer_Tone(3, 1000);
-              
-                err_tick = HAL_GetTick();
-                SysState = SYS_ERROR;
-                SysData_Save_State(); //״̬˱
-            }
         }
         break;
 
@@ -346,39 +524,32 @@ int main(void)
                 led_count++;
                 led_tick = HAL_GetTick();
             }
-          
-            if (HAL_GetTick() - open_tick >= 50000)
-            {
-                /* 5s */
-                FlowSafetyToken = 0;
-              
-                Servo_Set(SERVO_CLOSE);
-                LED_All_Off();
-                Password_Reset();
-                SysState = SYS_IDLE;
-                SysData_Save_State(); //״̬˱
-            }
-        }
-        break;
-
-        /* ==================   ================== */
-        case SYS_ERROR:
-        {
-
-            /*  */
-            if (HAL_GetTick() - err_tick >= 20000)
-            {
-								LED_All_Off();
-                Password_Reset();
-                SysState = SYS_IDLE;
-            }
         }
         break;
 
+        /* У: ʱ; :  2s,  Door_Step  */
         default:
-            SysState = SYS_IDLE;
             break;
     }
+
+      // ״̬˼һ, ʱͬ״̬ڱSRAM
+      if (door.state != trace_state)
+      {
+          trace_state = door.state;
+          Fault_Trace(FAULT_TRC_STATE, door.state);
+      }
+
+      Supervisor_Beat(SUP_TASK_LOOP);
+
+      // ȫڼûʲô, ˯һж (SysTick 100us)
+      if (door.state == SYS_IDLE || door.state == SYS_ERROR) Lockout_Sleep();
+
+      // һѭ, ⰴڴ, 
+      if (!boot_deferred)
+      {
+          BootProf_Mark(BOOT_STAGE_LOOP);
+          Boot_Deferred();
+      }
   }
 }
 
@@ -397,7 +568,14 @@ void SystemClock_Config(void)
   RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_HSI;
   RCC_OscInitStruct.HSIState = RCC_HSI_ON;
   RCC_OscInitStruct.HSICalibrationValue = 16;
-  RCC_OscInitStruct.PLL.PLLState = RCC_PLL_NONE;
+  /* PLL only feeds PLL48CLK for the RNG (16 / 8 * 192 / 8 = 48 MHz),
+     SYSCLK stays on HSI */
+  RCC_OscInitStruct.PLL.PLLState = RCC_PLL_ON;
+  RCC_OscInitStruct.PLL.PLLSource = RCC_PLLSOURCE_HSI;
+  RCC_OscInitStruct.PLL.PLLM = 8;
+  RCC_OscInitStruct.PLL.PLLN = 192;
+  RCC_OscInitStruct.PLL.PLLP = RCC_PLLP_DIV4;
+  RCC_OscInitStruct.PLL.PLLQ = 8;
   HAL_RCC_OscConfig(&RCC_OscInitStruct);
 
   RCC_ClkInitStruct.ClockType = RCC_CLOCKTYPE_PCLK1|RCC_CLOCKTYPE_PCLK2;
@@ -417,6 +595,92 @@ void SystemClock_Config(void)
 
 /* USER CODE BEGIN 4 */
 
+/**
+  * @brief һѭ֮һ: дڼµ, ӡϢ
+  * һĸ׶κʱ, ѱʱ뱸SRAM
+  */
+void Boot_Deferred(void)
+{
+    boot_deferred = 1;
+    Seg_Release();
+
+    //  (ӡ, Ĳһ), , һε Report
+    BootProf_Mark(BOOT_STAGE_DEFER);
+    BootProf_Finish(SysHotStart, ckpt_resume, ckpt_resume ? DWT_Cycle_To_Us(ckpt_gap_cycles) : 0);
+
+    // , ׿ϢԼ 1KB, Ҫ 80~90ms. ÿ 200ms һ,
+    // ֻȫ; ʱλĲ,  (Ź) һ
+    if (SysHotStart)
+    {
+        if (!ckpt_resume) BootProf_Summary();
+        Fault_Report();             // ϴʹֳ, ƽʱʲôҲ
+        return;
+    }
+    Boot_Report();
+}
+
+/**
+  * @brief Ϣ, ģͳƺһĸ׶κʱ. ʱһ,
+  * ֮ô 'B' ʱ (ļ׼Ҫʮ).
+  * [Persist]/[WDG] ۼ, ֻһλ
+  */
+void Boot_Report(void)
+{
+    printf("\n\r=================================================");
+    printf("\n\r        STM32F407 ˽ҳϵͳ       ");
+    printf("\n\r=================================================");
+    KV_Stats_t kvs;
+    KV_GetStats(&kvs);
+    printf("\n\r [KV] gen %u, %u keys, %u/%u slots, index %u us",
+           kvs.gen, kvs.keys, kvs.used, kvs.capacity, kvs.index_us);
+    AccessLog_Stats_t ls;
+    AccessLog_GetStats(&ls);
+    Cred_Stats_t cs;
+    Cred_GetStats(&cs);
+    printf("\n\r [Cred] %u/%u slots used", cs.count, CRED_MAX);
+    Cred_Bench();
+    Pwd_Ct_Bench();
+    Rng_Report();
+    Visitor_Stats_t vs;
+    Visitor_GetStats(&vs);
+    printf("\n\r [TOTP] %u/%u visitors", vs.count, VISITOR_MAX);
+    Keymap_Stats_t ks;
+    Keymap_GetStats(&ks);
+    printf("\n\r [IR] Keymap %u/%u%s", ks.count, KEYMAP_MAX, ks.factory ? " (factory)" : "");
+    IR_Report();
+    Visitor_Bench();
+    if (Lockout_Global()) Lockout_Report();
+    printf("\n\r [Log] %u stored, %u staged, next #%u, locate %u us",
+           ls.stored, ls.staged, ls.next_seq, ls.init_us);
+    RTC_Calendar_t now;
+    if (RTC_Calendar_Get(&now))
+        printf("\n\r [RTC] %04u-%02u-%02u %02u:%02u:%02u (weekday %u)",
+               now.year, now.month, now.day, now.hour, now.minute, now.second, now.weekday);
+    else
+        printf("\n\r [RTC] Clock not set, send TYYMMDDhhmmss to set it.");
+    if (ckpt_resume)
+        printf("\n\r [Ckpt] Outputs back %u us, resumed %u us after reset",
+               ckpt_output_us, ckpt_resume_us);
+    Persist_Stats_t ps;
+    Persist_GetStats(&ps);
+    printf("\n\r [Persist] %u marks -> %u commits, %u words since power-on (seq %u), check %u us",
+           ps.marks, ps.commits, ps.words, ps.seq, ps.validate_us);
+    Sup_Stats_t ss;
+    Supervisor_GetStats(&ss);
+    printf("\n\r [WDG] slack loop %d, servo %d, adc %d ticks; late %u/%u/%u, held %u of %u since power-on",
+           ss.task[SUP_TASK_LOOP].min_slack, ss.task[SUP_TASK_SERVO].min_slack,
+           ss.task[SUP_TASK_ADC].min_slack, ss.task[SUP_TASK_LOOP].late,
+           ss.task[SUP_TASK_SERVO].late, ss.task[SUP_TASK_ADC].late, ss.held, ss.checks);
+
+    BootProf_Report();
+    Fault_Report();             // ϴʹֳ
+    printf("\n\r [ϵͳܾ]");
+    printf("\n\r 1.  Ž: ʹúң");
+    printf("\n\r    - : 0-9, CH-ɾ");
+    printf("\n\r-------------------------------------------------");
+    printf("\n\r ϵͳʼɣ... \n\r");
+}
+
 /* ============================================================ */
 /* ================ ݵԪ뱸ʵ ================== */
 /* ============================================================ */
@@ -436,27 +700,25 @@ void SystemClock_Config(void)
 /* USER CODE BEGIN 4 ʵ */
 uint8_t SysData_Validate(void)
 {
-    // 1. ״̬ (SysState) ǷöٷΧ
-    uint32_t state_val = BKP_REG_STATE;
+    // 1. ״̬ (door.state) ǷöٷΧ
+    uint32_t state_val = PersistData.sys.state;
     if (state_val > SYS_ERROR) return 0;
 
-    // 2.  (input_index) ǷԽ
-    uint32_t idx_val = BKP_REG_IDX;
+    // 2.  (door.input_index) ǷԽ
+    uint32_t idx_val = PersistData.sys.input_index;
     if (idx_val > PASSWORD_LEN) return 0;
 
     return 1; // ͨ
 }
 
-void SysData_Init(void)
+/**
+  * @brief GPIO ʼϵ: жϸλԴ, رSRAM.
+  * ʱλµļЧʱ, Ȱ LED/̵ָɸλǰ,
+  *  (ZLG7290 λڼһֱʾ) ֻݲд
+  */
+void SysData_Early_Init(void)
 {
-    // 1. Դͱ
-    __HAL_RCC_PWR_CLK_ENABLE();
-    HAL_PWR_EnableBkUpAccess();
-    
-    // ؼֹ LED жϹ˸ٴǿƹر
-    LED_All_Off();
-
-    // 2. 鸴λԴ
+    // 1. 鸴λԴ
     uint8_t is_hot_start = 0;
     
     if (__HAL_RCC_GET_FLAG(RCC_FLAG_IWDGRST) != RESET || 
@@ -465,25 +727,56 @@ void SysData_Init(void)
     {
         is_hot_start = 1; 
     }
+    SysHotStart = is_hot_start;
     
     __HAL_RCC_CLEAR_RESET_FLAGS();
 
-    // 3. 鱸 (˫֤ħ + ݺϷ)
-    if (BKP_REG_MAGIC == BKP_MAGIC_NUMBER && SysData_Validate() == 1 && is_hot_start == 1)
+    // 2. 򿪱SRAM, ʱµЧ(CRCУ) PersistData
+    sys_restored = Persist_Init(is_hot_start);
+
+    // 3. ֻһ; λǰڳ 1s ˵Ǵζʱλ, ͨ
+    if (sys_restored && PersistData.ckpt.valid)
+    {
+        ckpt_gap_cycles = boot_cycles - PersistData.ckpt.reset_cycles;
+        ckpt_resume = (ckpt_gap_cycles + DWT_CYCCNT_GET() < SystemCoreClock);
+        PersistData.ckpt.valid = 0;
+        Persist_MarkDirty(PERSIST_REC_CKPT);
+    }
+
+    if (ckpt_resume)
+    {
+        LED_Set_Mask(PersistData.ckpt.led_mask);
+        Relay_Control(PersistData.ckpt.relay);
+        memcpy(seg_shadow, PersistData.ckpt.display, sizeof(seg_shadow));
+        seg_shadow_valid = 1;
+        ckpt_output_us = DWT_Cycle_To_Us(ckpt_gap_cycles + DWT_CYCCNT_GET());
+    }
+    else
+    {
+        LED_All_On();   // 
+    }
+}
+
+void SysData_Init(void)
+{
+    // ؼֹ LED жϹ˸ٴǿƹر (ָĳ)
+    if (!ckpt_resume) LED_All_Off();
+
+    Door_Init(&door);
+
+    uint8_t is_hot_start = SysHotStart;
+
+    // ժҪ Flash ֵȡ (KV_Init  RAM , ܿ)
+    Pwd_Load_t pwd_src = Pwd_Load(&sysData.pwd, DEFAULT_PASSWORD);
+    if (pwd_src == PWD_LOAD_MIGRATED)
+    {
+        printf("\r\n [System] Plain password in flash replaced by salted digest.");
+    }
+
+    // 鱸 (˫֤CRC + ݺϷ)
+    if (sys_restored && SysData_Validate() == 1 && is_hot_start == 1)
     {
         // === Ч ===
-        
-        // ָ
-        uint32_t data1 = BKP_REG_PWD_1;
-        uint32_t data2 = BKP_REG_PWD_2;
-        sysData.password[0] = (uint8_t)(data1 >> 0);
-        sysData.password[1] = (uint8_t)(data1 >> 8);
-        sysData.password[2] = (uint8_t)(data1 >> 16);
-        sysData.password[3] = (uint8_t)(data1 >> 24);
-        sysData.password[4] = (uint8_t)(data2 >> 0);
-        sysData.password[5] = (uint8_t)(data2 >> 8);
-        sysData.password[6] = (uint8_t)(data2 >> 16);
-        sysData.password[7] = (uint8_t)(data2 >> 24);
 
         if (is_hot_start)
         {
@@ -491,20 +784,22 @@ void SysData_Init(void)
             // printf("\r\n [System] Hot Start Detected!");
             
             // ָ״̬
-            SysState = (SystemState_t)BKP_REG_STATE;
+            door.state = (SystemState_t)PersistData.sys.state;
             
-            // ָĻʾ
-            if (SysState == SYS_INPUT_PWD) 
+            // ָĻʾ (Уиλ, 8λҲҪָУ)
+            if (door.state == SYS_INPUT_PWD || door.state == SYS_VERIFY)
             {
                 SysData_Restore_Input();
             }
-            else if (SysState == SYS_IDLE)
+            else if (door.state == SYS_IDLE)
             {
-                Password_Reset();
+                // ָʱĻϻǸλǰ (ǵʾ), 
+                if (ckpt_resume) Password_Clear();
+                else             Password_Reset();
             }
             
             // 
-            if (SysState == SYS_OPEN)
+            if (door.state == SYS_OPEN)
             {
                 FlowSafetyToken = FLOW_TOKEN_VALID; 
             }
@@ -515,11 +810,12 @@ void SysData_Init(void)
 
             // ؼָӲ״̬ (ǵ MX_GPIO_Init Ĭ״̬)
             System_Restore_Hardware();
+            if (ckpt_resume) Checkpoint_Restore();
         }
         else
         {
-            SysState = SYS_IDLE; 
-            BKP_REG_STATE = SYS_IDLE; 
+            door.state = SYS_IDLE; 
+            SysData_Save_State(); 
             Password_Reset();
 
             HAL_Delay(100); 
@@ -528,13 +824,18 @@ void SysData_Init(void)
     else
     {
         // ===  (ޱ) ===
-        printf("\r\n [System] Factory Reset.");
         HAL_TIM_PWM_Start(&htim12, TIM_CHANNEL_1);
-        // Ĭ
-        memcpy(sysData.password, DEFAULT_PASSWORD, PASSWORD_LEN);
-        SysData_Save_PWD(); 
+        // ϵժҪ Flash ֵȡ, ûѻĬ (Pwd_Load)
+        if (pwd_src == PWD_LOAD_FACTORY)
+        {
+            printf("\r\n [System] Factory Reset.");
+        }
+        else
+        {
+            printf("\r\n [System] Password restored from flash.");
+        }
         
-        SysState = SYS_IDLE;
+        door.state = SYS_IDLE;
         SysData_Save_State(); 
         
         Password_Reset();
@@ -544,87 +845,104 @@ void SysData_Init(void)
     }
 }
 
-//  (ֻ޸ʱ)
-void SysData_Save_PWD(void)
-{
-    uint32_t data1 = 0, data2 = 0;
-    
-    data1 |= ((uint32_t)sysData.password[0] << 0);
-    data1 |= ((uint32_t)sysData.password[1] << 8);
-    data1 |= ((uint32_t)sysData.password[2] << 16);
-    data1 |= ((uint32_t)sysData.password[3] << 24);
-    
-    data2 |= ((uint32_t)sysData.password[4] << 0);
-    data2 |= ((uint32_t)sysData.password[5] << 8);
-    data2 |= ((uint32_t)sysData.password[6] << 16);
-    data2 |= ((uint32_t)sysData.password[7] << 24);
-    
-    BKP_REG_PWD_1 = data1;
-    BKP_REG_PWD_2 = data2;
-    BKP_REG_MAGIC = BKP_MAGIC_NUMBER;
-}
-
-// ״̬ (״̬лʱ)
+// ״̬ (״̬лʱ). ״̬лύ, ֮ͬǰµĸĶһд
 void SysData_Save_State(void)
 {
-    BKP_REG_STATE = (uint32_t)SysState;
+    PersistData.sys.state = (uint8_t)door.state;
+    Persist_MarkDirty(PERSIST_REC_SYS);
+    Persist_Flush();
 }
 
 
 // Ӳָ
 void System_Restore_Hardware(void)
 {
-    switch(SysState)
+    switch(door.state)
     {
         case SYS_OPEN:
             Servo_Set(SERVO_OPEN); 
-            open_tick = HAL_GetTick(); 
+            door.open_tick = HAL_GetTick(); 
             // ָʱLED״̬ (򵥴Ϊ)
             break;
             
         case SYS_ERROR:
-            LED_All_On(); 
-            err_tick = HAL_GetTick();
+            if (!ckpt_resume) LED_All_On(); 
+            door.err_tick = HAL_GetTick();
+            break;
+
+        case SYS_INPUT_PWD:
+            door.key_tick = HAL_GetTick();   // 볬ʱͷ
+            Servo_Set(SERVO_CLOSE);
+            if (!ckpt_resume) LED_All_Off();
+            break;
+
+        case SYS_VERIFY:
+            // ʱλУ, ǿŹ⸴λ: ³ʱ
+            door.verify_due = HAL_GetTick() + Entropy_Range(VERIFY_JITTER_MIN, VERIFY_JITTER_MAX);
+            Servo_Set(SERVO_CLOSE);
+            if (!ckpt_resume) LED_All_Off();
             break;
             
         // ؼ IDLE, INPUT ״̬
-        // ȷصЩ״̬Ӳǹرյ
+        // ȷصЩ״̬Ӳǹرյ (ָ LED )
         default: 
             Servo_Set(SERVO_CLOSE);
-            LED_All_Off();
+            if (!ckpt_resume) LED_All_Off();
             break;
     }
 }
+
+/**
+  * @brief ʱλǰ: »ʣʱ (ѹȥ tick ), λ,
+  * LED/̵. ȡ DWT , λλʱʱ
+  */
+void Checkpoint_Save(void)
+{
+    Persist_Ckpt_t *ck = &PersistData.ckpt;
+    uint32_t now = HAL_GetTick();
+
+    ck->open_elapsed = now - door.open_tick;
+    ck->err_elapsed  = now - door.err_tick;
+    ck->key_elapsed  = now - door.key_tick;
+    ck->led_elapsed  = now - led_tick;
+    ck->led_count    = led_count;
+    ck->led_mask     = LED_Get_Mask();
+    ck->relay        = (RELAY_PORT->ODR & RELAY_PIN) ? 1 : 0;
+    memcpy(ck->display, seg_shadow, sizeof(ck->display));
+    ck->valid        = seg_shadow_valid;   // ûдܾͲ֪ʲô, 
+    ck->reset_cycles = DWT_CYCCNT_GET();
+    Persist_MarkDirty(PERSIST_REC_CKPT);
+}
+
+/**
+  * @brief ָ״̬: ʱϸλʱ, LED Ļظλǰ
+  */
+void Checkpoint_Restore(void)
+{
+    const Persist_Ckpt_t *ck = &PersistData.ckpt;
+    uint32_t gap = (ckpt_gap_cycles + DWT_CYCCNT_GET()) / (SystemCoreClock / 10000);   //  -> 100us tick
+    uint32_t now = HAL_GetTick();
+
+    door.open_tick = now - (ck->open_elapsed + gap);
+    door.err_tick  = now - (ck->err_elapsed + gap);
+    door.key_tick  = now - (ck->key_elapsed + gap);
+    led_tick  = now - (ck->led_elapsed + gap);
+    led_count = ck->led_count;
+    LED_Set_Mask(ck->led_mask);
+}
 /* USER CODE BEGIN 4 */
 
 
 
 /**
   * @brief 浱ǰ뻺ͽȵ
-  * ÿΰɾʱҪ
+  * ÿΰɾʱҪ. ֻľ񲢱,  Persist_Task ʱύ
   */
 void SysData_Save_Input(void)
 {
-    // 1. 
-    BKP_REG_IDX = (uint32_t)input_index;
-    
-    // 2. 뻺 (input_buf)
-    uint32_t data1 = 0, data2 = 0;
-    
-    // ѹǰ4λ
-    data1 |= ((uint32_t)input_buf[0] << 0);
-    data1 |= ((uint32_t)input_buf[1] << 8);
-    data1 |= ((uint32_t)input_buf[2] << 16);
-    data1 |= ((uint32_t)input_buf[3] << 24);
-    
-    // ѹ4λ
-    data2 |= ((uint32_t)input_buf[4] << 0);
-    data2 |= ((uint32_t)input_buf[5] << 8);
-    data2 |= ((uint32_t)input_buf[6] << 16);
-    data2 |= ((uint32_t)input_buf[7] << 24);
-    
-    BKP_REG_INBUF_1 = data1;
-    BKP_REG_INBUF_2 = data2;
+    PersistData.sys.input_index = door.input_index;
+    memcpy(PersistData.sys.input_buf, door.input_buf, DISP_LEN);
+    Persist_MarkDirty(PERSIST_REC_SYS);
 }
 
 /**
@@ -634,60 +952,307 @@ void SysData_Save_Input(void)
 void SysData_Restore_Input(void)
 {
     // 1. ָ
-    input_index = (uint8_t)BKP_REG_IDX;
+    door.input_index = PersistData.sys.input_index;
     
     // ȫ飺ˣǿ
-    if (input_index > PASSWORD_LEN) input_index = 0;
+    if (door.input_index > PASSWORD_LEN) door.input_index = 0;
     
     // 2. ָ buffer 
-    uint32_t data1 = BKP_REG_INBUF_1;
-    uint32_t data2 = BKP_REG_INBUF_2;
-    
-    input_buf[0] = (uint8_t)(data1 >> 0);
-    input_buf[1] = (uint8_t)(data1 >> 8);
-    input_buf[2] = (uint8_t)(data1 >> 16);
-    input_buf[3] = (uint8_t)(data1 >> 24);
-    
-    input_buf[4] = (uint8_t)(data2 >> 0);
-    input_buf[5] = (uint8_t)(data2 >> 8);
-    input_buf[6] = (uint8_t)(data2 >> 16);
-    input_buf[7] = (uint8_t)(data2 >> 24);
+    memcpy(door.input_buf, PersistData.sys.input_buf, DISP_LEN);
     
     // 3. ؽʾ (display_buf) ˢĻ
     // ߼Ѿλʾ'*'ûλʾ'blank'(14)
     for (int i = 0; i < DISP_LEN; i++)
     {
-        if (i < input_index)
+        if (i < door.input_index)
         {
             display_buf[i] = SEG_STAR; // ʾ *
         }
         else
         {
             display_buf[i] = 14;       // δʾ
-            input_buf[i] = 14;         // ȷ RAM һ
+            door.input_buf[i] = 14;    // ȷ RAM һ
         }
     }
     
     // 4. ˢ
     Seg_Display(display_buf);
     
-    printf("\r\n [Input] Restored: %d digits entered.", input_index);
+    if (!ckpt_resume) printf("\r\n [Input] Restored: %d digits entered.", door.input_index);
+}
+
+// Ч -> ʱ, 0 첻. ʱûʱ޵,  0xFFFFFFFF
+static uint32_t Console_Expiry(uint32_t days)
+{
+    uint32_t now = RTC_Now();
+
+    if (!days) return 0;
+    if (!now)
+    {
+        printf("\r\n [Console] Set the clock first for a code that expires.");
+        return 0xFFFFFFFFu;
+    }
+    return now + days * 86400u;
+}
+
+// C/D: û
+static void Console_Cred(uint8_t cmd, const uint8_t *arg)
+{
+    uint16_t slot = arg[0] * 100 + arg[1] * 10 + arg[2];
+    uint32_t days;
+    Cred_Entry_t e;
+
+    if (cmd == 'D')
+    {
+        if (Cred_Delete(slot))
+            printf("\r\n [Cred] Slot %u deleted", slot);
+        else
+            printf("\r\n [Cred] Delete failed (bad slot or flash full).");
+        return;
+    }
+
+    days = arg[17] * 100 + arg[18] * 10 + arg[19];
+    e.code = Cred_Pack(&arg[3]);
+    e.owner = 0;
+    for (int i = 11; i < 16; i++) e.owner = e.owner * 10 + arg[i];
+    e.flags = CRED_FLAG_ENABLED;
+    e.rule = arg[16];
+    e.expiry = Console_Expiry(days);
+    e.uses = 0;
+    if (e.expiry == 0xFFFFFFFFu) return;
+
+    if (Cred_Set(slot, &e))
+        printf("\r\n [Cred] Slot %u set, owner %u, rule %u, %u days", slot, e.owner, e.rule, days);
+    else
+        printf("\r\n [Cred] Set failed (bad slot or flash full).");
+}
+
+// V/X: ÿ TOTP
+static void Console_Visitor(uint8_t cmd, uint8_t *arg)
+{
+    uint16_t slot = arg[0];
+    uint32_t days;
+    Visitor_Meta_t m;
+
+    if (cmd == 'X')
+    {
+        if (Visitor_Delete(slot))
+            printf("\r\n [TOTP] Visitor %u deleted", slot);
+        else
+            printf("\r\n [TOTP] Delete failed (bad slot or flash full).");
+        return;
+    }
+
+    days = arg[8] * 100 + arg[9] * 10 + arg[10];
+    memset(&m, 0, sizeof(m));
+    m.digits = arg[1];
+    for (int i = 2; i < 7; i++) m.owner = m.owner * 10 + arg[i];
+    m.rule = arg[7];
+    m.expiry = Console_Expiry(days);
+    if (m.expiry == 0xFFFFFFFFu) return;
+
+    // 40 ʮ -> 20 ֽԿ, ͵ƴڲǰ, 
+    for (int i = 0; i < VISITOR_SECRET_LEN; i++)
+    {
+        arg[i] = (uint8_t)((arg[11 + i * 2] << 4) | arg[12 + i * 2]);
+    }
+    if (Visitor_Set(slot, arg, &m))
+        printf("\r\n [TOTP] Visitor %u set, owner %u, %u digits, rule %u, %u days",
+               slot, m.owner, m.digits, m.rule, days);
+    else
+        printf("\r\n [TOTP] Set failed (bad slot/digits or flash full).");
+}
+
+void IR_Report(void)
+{
+    IR_Stats_t is;
+
+    Remote_Infrared_GetStats(&is);
+    printf("\r\n [IR] %u frames, %u repeats, %u long; lost %u (queue full), %u orphan repeats, "
+           "%u bad, %u unknown; queue %u/%u (max %u)",
+           is.frames, is.repeats, is.longs, is.overflow, is.orphan, is.errors, is.unknown,
+           is.depth, IR_QUEUE_LEN, is.depth_max);
+}
+
+void Rng_Report(void)
+{
+    Entropy_Stats_t es;
+
+    Entropy_GetStats(&es);
+    printf("\r\n [RNG] pool %u/%u (low %u), %u in / %u out, %u underruns, %u repeats, %u errors",
+           es.depth, ENTROPY_POOL_WORDS, es.low_water, es.pushed, es.drawn,
+           es.underruns, es.repeats, es.errors);
+    if (es.refill_cycles)
+        printf("\r\n [RNG] refill %u words in %u us (max %u us)", es.refill_words,
+               DWT_Cycle_To_Us(es.refill_cycles), DWT_Cycle_To_Us(es.refill_max_cycles));
+}
+
+/**
+  * @brief , ѭѯ, ýж
+  *  L              ־ (Tools/alog_dump)
+  *  TYYMMDDhhmmss   RTC  (ʱ), Զ
+  *  CsssppppppppoooooRddd  û: sss, 8λ, ûooooo,
+  *                 ʱιR, Чddd (000: )
+  *  Dsss           ɾsssû
+  *  VsnoooooRddd<40λʮ>  ÷ÿ: s, λn (6~8), ûooooo,
+  *                 ʱιR, Чddd, 20ֽԿ (֤ base32 Ǵʮ)
+  *  Xs             ɾsÿ
+  *  K              ӡ״̬
+  *  R              ӡس״̬
+  *  I              ѧϰң: ΰ 0~9, DEL
+  *  M              ӡλ
+  *  Jaaaa          ɾַΪ aaaa (4 λʮ) ңȫ
+  *  E              ʼץԭʼ
+  *  F              ֹͣץ (Tools/ir_replay)
+  */
+void Console_Poll(void)
+{
+    static uint8_t arg_buf[11 + VISITOR_SECRET_LEN * 2];
+    static uint8_t arg_len = 0;
+    static uint8_t arg_need = 0;
+    static uint8_t cmd = 0;
+    uint8_t c, v;
+
+    if (!__HAL_UART_GET_FLAG(&huart1, UART_FLAG_RXNE)) return;
+    c = (uint8_t)(huart1.Instance->DR & 0xFF);
+
+    if (!cmd)
+    {
+        if (c == ALOG_DUMP_CMD)
+        {
+            AccessLog_Dump_Start();
+            return;
+        }
+        if (c == 'K')
+        {
+            Lockout_Report();
+            return;
+        }
+        if (c == 'R')
+        {
+            Rng_Report();
+            return;
+        }
+        if (c == 'I')
+        {
+            Keymap_Learn_Start();
+            return;
+        }
+        if (c == IR_CAP_START_CMD)
+        {
+            IR_Capture_Start();
+            return;
+        }
+        if (c == IR_CAP_DUMP_CMD)
+        {
+            IR_Capture_Dump_Start();
+            return;
+        }
+        if (c == 'M')
+        {
+            Keymap_Report();
+            IR_Report();
+            return;
+        }
+        if (c == 'B')
+        {
+            Boot_Report();
+            return;
+        }
+        switch (c)
+        {
+            case 'T': arg_need = 12; break;
+            case 'C': arg_need = 20; break;
+            case 'D': arg_need = 3;  break;
+            case 'V': arg_need = sizeof(arg_buf); break;
+            case 'X': arg_need = 1;  break;
+            case 'J': arg_need = 4;  break;
+            default:  arg_need = 0;  break;
+        }
+        if (arg_need)
+        {
+            cmd = c;
+            arg_len = 0;
+        }
+        return;
+    }
+
+    if (c >= '0' && c <= '9')
+        v = c - '0';
+    else if (((cmd == 'V' && arg_len >= 11) || cmd == 'J') && (c | 0x20) >= 'a' && (c | 0x20) <= 'f')
+        v = (c | 0x20) - 'a' + 10;
+    else
+    {
+        cmd = 0;   // ʽ, 
+        return;
+    }
+    arg_buf[arg_len++] = v;
+    if (arg_len < arg_need) return;
+
+    c = cmd;
+    cmd = 0;
+    if (c == 'C' || c == 'D')
+    {
+        Console_Cred(c, arg_buf);
+    }
+    else if (c == 'V' || c == 'X')
+    {
+        Console_Visitor(c, arg_buf);
+    }
+    else if (c == 'J')
+    {
+        uint16_t addr = (arg_buf[0] << 12) | (arg_buf[1] << 8) | (arg_buf[2] << 4) | arg_buf[3];
+        printf("\r\n [IR] Forgot remote 0x%04X: %u keys removed", addr, Keymap_Forget(addr));
+    }
+    else
+    {
+        RTC_Calendar_t cal;
+        cal.year   = 2000 + arg_buf[0] * 10 + arg_buf[1];
+        cal.month  = arg_buf[2] * 10 + arg_buf[3];
+        cal.day    = arg_buf[4] * 10 + arg_buf[5];
+        cal.hour   = arg_buf[6] * 10 + arg_buf[7];
+        cal.minute = arg_buf[8] * 10 + arg_buf[9];
+        cal.second = arg_buf[10] * 10 + arg_buf[11];
+        if (RTC_Calendar_Set(&cal))
+            printf("\r\n [RTC] Set to %04u-%02u-%02u %02u:%02u:%02u",
+                   cal.year, cal.month, cal.day, cal.hour, cal.minute, cal.second);
+        else
+            printf("\r\n [RTC] Set failed (clock not running or bad value).");
+    }
+    memset(arg_buf, 0, sizeof(arg_buf));   // Կ
 }
 
 
 int fputc(int ch, FILE *f)
 { 	
+	if (AccessLog_Dumping()) return ch;   // ־ʱڱ DMA ռ
+	if (IR_Capture_Dumping()) return ch;  // ץʱڷ
 	while((USART1->SR&0X40)==0);//ѭ,ֱ   
 	USART1->DR = (uint8_t) ch;      
 	return ch;
 }
 
-void HAL_SYSTICK_Callback(void)
+// д (). һͲд, ˢͬݲ
+static void Seg_Write(uint8_t *seg)
 {
-	if(GlobalTimingDelay100us != 0)
+    if (seg_hold)
     {
-       GlobalTimingDelay100us--;
+        memcpy(seg_next, seg, sizeof(seg_next));
+        seg_next_valid = 1;
+        return;
     }
+    if (seg_shadow_valid && memcmp(seg_shadow, seg, sizeof(seg_shadow)) == 0) return;
+
+    memcpy(seg_shadow, seg, sizeof(seg_shadow));
+    seg_shadow_valid = 1;
+    I2C_ZLG7290_Write(&hi2c1, 0x70, 0x10, seg, 8);
+}
+
+// , дڼһҪʾ
+void Seg_Release(void)
+{
+    seg_hold = 0;
+    if (seg_next_valid) Seg_Write(seg_next);
 }
 
 void Seg_Display(uint8_t *buf)
@@ -703,75 +1268,126 @@ void Seg_Display(uint8_t *buf)
     }
 
     /*д8ֽ*/
-    I2C_ZLG7290_Write(&hi2c1, 0x70, 0x10, seg_buf, 8);
+    Seg_Write(seg_buf);
 }
 
-void Password_Input(uint8_t num)
+// 뻺: λʾ *, û, ٴ汸
+void Password_Show(void)
 {
-    if (input_index < PASSWORD_LEN)
+    for (int i = 0; i < DISP_LEN; i++)
     {
-        /* 1.  */
-        input_buf[input_index] = num;
-
-        /* 2. * */
-        display_buf[input_index] = SEG_STAR;
-
-        input_index++;
-
-        /* 3. ˢ  */
-        Seg_Display(display_buf);
-			
-				SysData_Save_Input();
+        display_buf[i] = (i < door.input_index) ? SEG_STAR : 14;
     }
+    Seg_Display(display_buf);
+    SysData_Save_Input();
 }
 
 
 
-uint8_t Password_Check_Algorithm_A(void)  //㷨AXOR
+uint8_t Password_Check_Algorithm_A(const uint8_t *digest)  //㷨AXOR
 {
-    uint8_t diff_accumulator = 0; // ۼ
-    
-
-    for (int i = 0; i < PASSWORD_LEN; i++)
-    {
-        diff_accumulator |= (input_buf[i] ^ sysData.password[i]);
-    }
-    
-    //  diff_accumulator Ϊ 0,ÿһλͬ
-    return (diff_accumulator == 0) ? 1 : 0;
+    return Ct_Compare_Xor(digest, sysData.pwd.digest, SHA256_DIGEST_LEN);
 }
 
 
-uint8_t Password_Check_Algorithm_B(void)  //㷨B
+uint8_t Password_Check_Algorithm_B(const uint8_t *digest)  //㷨B
 {
-    uint8_t diff_accumulator = 0;
-    
-    for (int i = PASSWORD_LEN - 1; i >= 0; i--)
-    {
-        volatile uint8_t input_val = input_buf[i];
-        volatile uint8_t pass_val  = sysData.password[i];
-        
-        // ۼӲ
-        diff_accumulator |= (input_val - pass_val);
-    }
-    
-    return (diff_accumulator == 0) ? 1 : 0;
+    return Ct_Compare_Sub(digest, sysData.pwd.digest, SHA256_DIGEST_LEN);
 }
 
 
 uint8_t Password_Check(void)  //AB㷨м
 {
-    uint32_t random_seed = HAL_GetTick();
-    
+    uint32_t random_seed = Entropy_U32();
+    uint8_t digest[SHA256_DIGEST_LEN];
+    Pwd_Stats_t ps;
+    uint8_t ok;
+
+    // ͬժҪ, ȵժҪ
+    Pwd_Digest(&sysData.pwd, door.input_buf, digest);
+    Pwd_GetStats(&ps);
+    printf("\r\n [Security] Digest %u us (max %u, budget %u)", ps.hash_us, ps.hash_max_us, PWD_VERIFY_BUDGET_US);
+
+    // ѡĸ㷨ӡ: ʾڷʱ䲻ͬ, ǲŵ
     if (random_seed & 0x01) // ż
+        ok = Password_Check_Algorithm_A(digest);
+    else
+        ok = Password_Check_Algorithm_B(digest);
+    memset(digest, 0, sizeof(digest));
+    return ok;
+}
+
+/**
+  * @brief VERIFY ʱ: У, ־, , ٰѽ״̬.
+  *  Door_Verdict Ķ
+  */
+uint32_t Password_Verify(void)
+{
+    // , û, ÿ붼һ, Ϊǰ˾ʡ
+    uint32_t now_s = RTC_Now();
+    uint8_t master_ok = Password_Check();
+    int16_t cred = Cred_Verify(door.input_buf, now_s);
+    int16_t visitor = Visitor_Verify(door.input_buf, now_s);
+    Cred_Entry_t entry;
+    Visitor_Meta_t vm;
+    uint8_t rule = 0;                     // 0ʱι
+
+    if (master_ok) { cred = -1; visitor = -1; }
+    if (cred >= 0) visitor = -1;
+    if (cred >= 0 && Cred_Get(cred, &entry)) rule = entry.rule;
+    if (visitor >= 0 && Visitor_Get(visitor, &vm)) rule = vm.rule;
+    uint8_t pwd_ok = master_ok || cred >= 0 || visitor >= 0;
+    uint8_t in_window = Rule_Check(rule); // һλͼ
+    
+    if (pwd_ok && in_window)
     {
-        printf("\r\n [Security] Verifying using Algo A (Forward XOR)...");
-        return Password_Check_Algorithm_A();
+        AccessLog_Append(LOG_EVT_ACCESS, door.input_index, LOG_OUT_GRANTED, (uint8_t)door.state);
+        Lockout_Success(Remote_Infrared_LastID());
+        if (cred >= 0)
+        {
+            Cred_Stats_t cs;
+            Cred_Used(cred);
+            Cred_GetStats(&cs);
+            printf("\r\n [Cred] Slot %u, owner %u, used %u times (lookup %u us)",
+                   cred, entry.owner, entry.uses + 1, DWT_Cycle_To_Us(cs.verify_cycles));
+        }
+        if (visitor >= 0)
+        {
+            Visitor_Stats_t vs;
+            Visitor_Used(visitor);
+            Visitor_GetStats(&vs);
+            printf("\r\n [TOTP] Visitor %u, owner %u, used %u times (check %u us)",
+                   visitor, vm.owner, vm.uses + 1, DWT_Cycle_To_Us(vs.verify_cycles));
+        }
+        FlowSafetyToken = FLOW_TOKEN_VALID;
+        Seg_Show_OPEN();           // OPEN
+        Buzzer_Play_Melody();
+      
+        led_tick = HAL_GetTick();
+        led_count = 0;
+        return Door_Verdict(&door, 1, HAL_GetTick());   // ¼ʱ
     }
     else
     {
-        printf("\r\n [Security] Verifying using Algo B (Reverse SUB)...");
-        return Password_Check_Algorithm_B();
+        if (pwd_ok)
+        {
+            printf("\r\n [Rule] Password OK but outside the allowed time window.");
+        }
+        else
+        {
+            // ʱⲻ; һλңһ
+            uint32_t lock_s = Lockout_Fail(Remote_Infrared_LastID());
+            if (lock_s)
+                printf("\r\n [Lock] Too many failures, locked for %u s.", lock_s);
+        }
+        AccessLog_Append(LOG_EVT_ACCESS, door.input_index,
+                         pwd_ok ? LOG_OUT_SCHEDULE : LOG_OUT_DENIED, (uint8_t)door.state);
+        FlowSafetyToken = 0;
+      
+        Seg_Show_Err();            // Err
+        Buzzer_Tone(3, 1000);
+      
+        return Door_Verdict(&door, 0, HAL_GetTick());
     }
 }
 
@@ -779,45 +1395,38 @@ uint8_t Password_Check(void)  //
 void Seg_Show_OPEN(void)
 {
     uint8_t buf[8] = {14,14,0xFC,0xCE,0x9E,0x2A,14,14};
-    I2C_ZLG7290_Write(&hi2c1,0x70,0x10,buf,8);
+    Seg_Write(buf);
 }
 
 void Seg_Show_Err(void)
 {
     uint8_t buf[8] = {14,14,0x9E,0x0A,0x0A,14,14,14};
-    I2C_ZLG7290_Write(&hi2c1,0x70,0x10,buf,8);
+    Seg_Write(buf);
 }
 
-void Password_Reset(void)
+// ʾ: ʾ, ȴ
+void Seg_Show_Ready(void)
 {
-    input_index = 0;
-
-    for (int i = 0; i < DISP_LEN; i++){
-        input_buf[i] = 0;
-				display_buf[i] = 14;
-		}
-	
-    Seg_Display(display_buf);
-		SysData_Save_Input();
+    uint8_t buf[8] = {SEG_STAR,14,14,14,14,14,14,SEG_STAR};
+    Seg_Display(buf);
 }
 
-void Password_Delete(void)
+// ֻ뻺, Ļ
+void Password_Clear(void)
 {
-    if (input_index > 0)
-    {
-        input_index--;
-        input_buf[input_index] = 14;
-				display_buf[input_index] = 14;
+    Door_Clear(&door);
 
-        /* һλ */
-        Seg_Display(display_buf);
-				SysData_Save_Input();
-    }
+    for (int i = 0; i < DISP_LEN; i++){
+				display_buf[i] = 14;
+		}
 }
 
-void Servo_Set(uint16_t pwm)
+void Password_Reset(void)
 {
-    __HAL_TIM_SetCompare(&htim12, TIM_CHANNEL_1, pwm);
+    Password_Clear();
+	
+    Seg_Display(display_buf);
+		SysData_Save_Input();
 }
 
 // 1.ȫ
@@ -863,6 +1472,32 @@ void Turn_On_LED(uint8_t LED_NUM)
     }
 }
 
+// 4. /дȫLED, λͬ Turn_On_LED (͵ƽ)
+uint8_t LED_Get_Mask(void)
+{
+    uint8_t mask = 0;
+
+    if (!(GPIOH->ODR & GPIO_PIN_15)) mask |= 0x01;
+    if (!(GPIOB->ODR & GPIO_PIN_15)) mask |= 0x02;
+    if (!(GPIOC->ODR & GPIO_PIN_0))  mask |= 0x04;
+    if (!(GPIOF->ODR & GPIO_PIN_10)) mask |= 0x08;
+    return mask;
+}
+
+void LED_Set_Mask(uint8_t mask)
+{
+    HAL_GPIO_WritePin(GPIOH, GPIO_PIN_15, (mask & 0x01) ? GPIO_PIN_RESET : GPIO_PIN_SET);
+    HAL_GPIO_WritePin(GPIOB, GPIO_PIN_15, (mask & 0x02) ? GPIO_PIN_RESET : GPIO_PIN_SET);
+    HAL_GPIO_WritePin(GPIOC, GPIO_PIN_0,  (mask & 0x04) ? GPIO_PIN_RESET : GPIO_PIN_SET);
+    HAL_GPIO_WritePin(GPIOF, GPIO_PIN_10, (mask & 0x08) ? GPIO_PIN_RESET : GPIO_PIN_SET);
+}
+
+// ̵, ߵƽ
+void Relay_Control(uint8_t state)
+{
+    HAL_GPIO_WritePin(RELAY_PORT, RELAY_PIN, state ? GPIO_PIN_SET : GPIO_PIN_RESET);
+}
+
 /* === ƺ === */
 
 // ضƵʺʱ
@@ -876,8 +1511,10 @@ void Buzzer_Tone(uint32_t tone_delay, uint32_t duration_ms)
     //  = duration_ms * 10 / (tone_delay * 2)
     uint32_t toggle_counts = (duration_ms * 5) / tone_delay;
 
+    // ĳҪ 1s, ڼѭת: ÿڱһ, ѭʱ
     for(uint32_t i = 0; i < toggle_counts; i++)
     {
+        Supervisor_Beat(SUP_TASK_LOOP);
         HAL_GPIO_WritePin(GPIOG, GPIO_PIN_6, GPIO_PIN_SET);
         HAL_Delay(tone_delay); // ??Delay???100us
         HAL_GPIO_WritePin(GPIOG, GPIO_PIN_6, GPIO_PIN_RESET);
@@ -900,6 +1537,30 @@ void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
 		Remote_Infrared_KEY_ISR();
 }
 
+// ADC3 һɨDMA (Լ4kHz)
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc)
+{
+    if (hadc->Instance == ADC3)
+    {
+        Supervisor_Beat(SUP_TASK_ADC);
+        Presence_Update(adc_raw_data[ADC_IDX_PRESENCE]);
+        Light_Sample(adc_raw_data[ADC_IDX_LIGHT]);
+        Servo_Feedback(adc_raw_data[ADC_IDX_SERVO_FB]);
+        Obstruct_Sample(adc_raw_data[ADC_IDX_SERVO_CUR]);
+    }
+}
+
+// TIM12 ж, ÿPWM(20ms)һ
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef *htim)
+{
+    if (htim->Instance == TIM12)
+    {
+        Obstruct_Period_ISR();   // жת, ָŶ
+        Servo_Ctrl_ISR();
+        Supervisor_Beat(SUP_TASK_SERVO);
+    }
+}
+
 /* USER CODE BEGIN 4 */
 
 
@@ -919,14 +1580,14 @@ void MX_IWDG_Init(void)
   // 1. ʼ
   if (HAL_IWDG_Init(&hiwdg) != HAL_OK)
   {
-    while(1); // ???????
+    Fault_Record(FAULT_INIT_IWDG);   // ٸλ, پĬ
   }
 
   // 2. ????? (?? 0xCCCC ? KR ???)
   // ??:??????????????????!
   if (HAL_IWDG_Start(&hiwdg) != HAL_OK)
   {
-    while(1); // 
+    Fault_Record(FAULT_INIT_IWDG);   // : ٸλ
   }
 }
 /* USER CODE END 4 *
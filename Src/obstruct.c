@@ -0,0 +1,152 @@
+#include "obstruct.h"
+#include "servo.h"
+#include "dwt.h"
+
+/************************************************************************
+* ת/ ( ADC3_IN7, PF9)
+*
+* Դ 0.1R ,  20 Ŵ PF9,  2V/A.
+* ADC ɨԼ 4kHz, ÿ ADC жۼ; TIM12 ж(PWMڱ߽)
+* ȡһڵۼֵƽ, ж PWM ϸ,
+* һĵӰ.
+*
+*  OBSTRUCT_PERIODS ƽ޼жת, ж
+* ֱӵ Servo_Obstruct_ISR , ڽŵ PendSV 滮, 
+* ѭ (ѭһξϰms). ÿζʼ OBSTRUCT_BLANK_PERIODS 
+* , .
+*
+* ӳϽ: ޿ʼڵĲ + OBSTRUCT_PERIODS ,
+*  (OBSTRUCT_PERIODS + 1) * 20ms. ʵӳٴӵһ޲ (DWT ʱ)
+* ָ, ÿζϱ, Ͻʱǳ.
+*************************************************************************/
+
+#define OBSTRUCT_UA_PER_LSB       403     // 3300mV/4095 / 2V/A
+#define OBSTRUCT_LIMIT_MA         800     // Լ 300~500mA, ת 1A 
+#define OBSTRUCT_LIMIT_ADC        ((uint32_t)OBSTRUCT_LIMIT_MA * 1000 / OBSTRUCT_UA_PER_LSB)
+#define OBSTRUCT_PERIODS          2       // 
+#define OBSTRUCT_BLANK_PERIODS    2       // ʼе
+#define OBSTRUCT_PERIOD_US        20000
+#define OBSTRUCT_BOUND_US         ((OBSTRUCT_PERIODS + 1) * OBSTRUCT_PERIOD_US)
+
+#if OBSTRUCT_ENABLE
+static __IO uint32_t cur_sum = 0;
+static __IO uint16_t cur_cnt = 0;
+static __IO uint8_t  cur_last_over = 0;
+static __IO uint32_t onset_cycles = 0;    // ֳ޿ʼʱ, 0: ûг
+
+static int8_t  obs_dir = 0;
+static uint8_t obs_blank = 0;
+static uint8_t obs_over = 0;
+#endif
+
+static Obstruct_Report_t obs_rep;
+
+
+void Obstruct_Init(void)
+{
+#if OBSTRUCT_ENABLE
+    cur_sum = 0;
+    cur_cnt = 0;
+    cur_last_over = 0;
+    onset_cycles = 0;
+    obs_dir = 0;
+    obs_blank = 0;
+    obs_over = 0;
+#endif
+    obs_rep.dir = 0;
+    obs_rep.over_bound = 0;
+    obs_rep.current_ma = 0;
+    obs_rep.periods = 0;
+    obs_rep.latency_us = 0;
+    obs_rep.max_latency_us = 0;
+    obs_rep.bound_us = OBSTRUCT_BOUND_US;
+    obs_rep.count = 0;
+}
+
+void Obstruct_Sample(uint16_t adc)
+{
+#if OBSTRUCT_ENABLE
+    cur_sum += adc;
+    cur_cnt++;
+
+    cur_last_over = (adc > OBSTRUCT_LIMIT_ADC);
+    if (cur_last_over && onset_cycles == 0)
+    {
+        onset_cycles = DWT_CYCCNT_GET() | 1u;
+    }
+#endif
+}
+
+/**
+  * @brief ÿPWMڽʱжһ
+  */
+void Obstruct_Period_ISR(void)
+{
+#if OBSTRUCT_ENABLE
+    uint32_t sum, mean, latency;
+    uint16_t cnt;
+    uint8_t last_over;
+    int8_t dir = Servo_Motion_Dir();
+
+    // ADC жȼ, ȡۼֵʱж
+    __disable_irq();
+    sum = cur_sum;
+    cnt = cur_cnt;
+    last_over = cur_last_over;
+    cur_sum = 0;
+    cur_cnt = 0;
+    __enable_irq();
+
+    if (cnt == 0) return;
+    mean = sum / cnt;
+
+    // ¶ (), 
+    if (dir != obs_dir)
+    {
+        obs_dir = dir;
+        obs_blank = 0;
+        obs_over = 0;
+    }
+
+    if (dir == 0 || obs_blank < OBSTRUCT_BLANK_PERIODS)
+    {
+        if (dir != 0) obs_blank++;
+        obs_over = 0;
+        onset_cycles = 0;
+        return;
+    }
+
+    if (mean <= OBSTRUCT_LIMIT_ADC)
+    {
+        // ĩβտʼ޵, ʱ㵽һ
+        obs_over = 0;
+        if (!last_over) onset_cycles = 0;
+        return;
+    }
+
+    if (++obs_over < OBSTRUCT_PERIODS) return;
+
+    // жת: ȷ, ټ¼
+    Servo_Obstruct_ISR();
+
+    latency = onset_cycles ? DWT_Cycle_To_Us(DWT_CYCCNT_GET() - onset_cycles) : 0;
+
+    obs_rep.dir = dir;
+    obs_rep.current_ma = (uint16_t)(mean * OBSTRUCT_UA_PER_LSB / 1000);
+    obs_rep.periods = obs_over;
+    obs_rep.latency_us = latency;
+    obs_rep.over_bound = (latency > OBSTRUCT_BOUND_US);
+    if (latency > obs_rep.max_latency_us) obs_rep.max_latency_us = latency;
+    obs_rep.count++;
+
+    obs_over = 0;
+    onset_cycles = 0;
+#endif
+}
+
+void Obstruct_GetReport(Obstruct_Report_t *rep)
+{
+    __disable_irq();
+    *rep = obs_rep;
+    __enable_irq();
+}
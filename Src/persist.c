@@ -0,0 +1,237 @@
+#include "persist.h"
+#include "crc.h"
+#include "dwt.h"
+#include "string.h"
+#include "stddef.h"
+
+/************************************************************************
+* SRAM״̬־ (BKPSRAM, 4KB, ع)
+*
+* ԭǰֹֽƴ RTC->BKPxR, һֻ20, ÿһֶ
+* Ҫλ. Ҫ縴λݷһṹ Persist_Data_t ,
+* ڱSRAMд A/B :
+*
+*   | magic | version | length | seq | Persist_Data_t | crc32 |
+*
+* ύʱд""һ, CRC д. дһ븴λ, һ CRC Բ,
+* һһĿ, Բдһ.
+* ʱݶУ, ȡ seq µЧǷ, 鿽 RAM .
+*
+* дϲ: ޸ RAM ֻ Persist_MarkDirty Ǽ¼, д.
+* ڹ̶ʱͳһύ (״̬л, λǰ, Լ PERSIST_FLUSH_TICKS ĵƵ
+* ʱ), ٿҲֻǶǼ. ύʱֻĹļ¼: ҪдǸ
+* ¿һύ, Ҫд "θĶ | ϴύĸĶ".
+*
+* CRC Ӳ CRC Ԫ (CRC_Calc32), ÿԼһ;  crc32_sw.c
+* õͬĽ. ȱݵͷ,  seq µһݿʼУ, þ
+* һ, Уʱֻһݼ¼ĳȳ, ʵ validate_us.
+*
+* /ύ/дֱӼڱSRAM (BKPSRAM_PSTAT_ADDR), :
+* ÿ 200ms ʱλһ,  RAM ֻܿһ.
+*************************************************************************/
+
+#define PERSIST_MAGIC        0x4A524E4Cu   // "JRNL"
+#define PERSIST_SLOT_SIZE    0x400         // ÿ 1KB
+#define PERSIST_SLOT(n)      ((Persist_Slot_t *)(BKPSRAM_PERSIST_ADDR + (n) * PERSIST_SLOT_SIZE))
+#define PERSIST_FLUSH_TICKS  500           // ʱύ 50ms (100us tick)
+#define PERSIST_REC_NUM      7
+#define PERSIST_CNT_MAGIC    0x544E4350u   // "PCNT"
+#define PERSIST_CNT          ((Persist_Count_t *)BKPSRAM_PSTAT_ADDR)
+
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t length;          // sizeof(Persist_Data_t)
+    uint32_t seq;             // ύ, ȡµ
+    Persist_Data_t data;
+    uint32_t crc;             // ֵ CRC
+} Persist_Slot_t;
+
+// 縴λۼƵļ
+typedef struct
+{
+    uint32_t magic;
+    uint32_t marks;
+    uint32_t commits;
+    uint32_t words;
+} Persist_Count_t;
+
+// ڼ: ṹֶҷŵýһ
+typedef char persist_size_check[(sizeof(Persist_Slot_t) % 4 == 0 &&
+                                 sizeof(Persist_Slot_t) <= PERSIST_SLOT_SIZE &&
+                                 sizeof(Persist_Count_t) <= 0x20) ? 1 : -1];
+
+// ¼ Persist_Data_t еλ, ˳ PERSIST_REC_xxx λһ
+static const struct
+{
+    uint16_t offset;
+    uint16_t size;
+} persist_rec[PERSIST_REC_NUM] =
+{
+    { offsetof(Persist_Data_t, sys),      sizeof(Persist_Sys_t) },
+    { offsetof(Persist_Data_t, presence), sizeof(Persist_Presence_t) },
+    { offsetof(Persist_Data_t, light),    sizeof(Persist_Light_t) },
+    { offsetof(Persist_Data_t, servo),    sizeof(Persist_Servo_t) },
+    { offsetof(Persist_Data_t, ckpt),     sizeof(Persist_Ckpt_t) },
+    { offsetof(Persist_Data_t, visitor),  sizeof(Persist_Visitor_t) },
+    { offsetof(Persist_Data_t, lock),     sizeof(Persist_Lock_t) },
+};
+
+Persist_Data_t PersistData;
+
+static int8_t   persist_active = -1;   // ǰЧڵĲ, -1: û
+static uint32_t persist_seq = 0;
+static uint32_t persist_dirty = 0;     // ϴύĹļ¼
+static uint32_t persist_last = 0;      // ϴύдĸĶ, һۻȱЩ
+static uint8_t  persist_synced[2];     // ò۴ǲǽŵһݿ
+static uint32_t persist_flush_tick = 0;
+static Persist_Stats_t persist_stats;
+
+
+static uint32_t Persist_Slot_Crc(const Persist_Slot_t *slot)
+{
+    return CRC_Calc32((const uint32_t *)slot, (sizeof(Persist_Slot_t) - 4) / 4);
+}
+
+static uint8_t Persist_Slot_Head_Ok(const Persist_Slot_t *slot)
+{
+    return slot->magic == PERSIST_MAGIC &&
+           slot->version == PERSIST_VERSION &&
+           slot->length == sizeof(Persist_Data_t);
+}
+
+/**
+  * @brief 򿪱SRAM, ʱָµЧ.
+  * ݶЧʱ RAM , ģ鰴Ե valid ־Ĭֵ
+  */
+uint8_t Persist_Init(uint8_t is_hot_start)
+{
+    uint8_t head_a, head_b, order[2];
+    uint32_t t0;
+
+    __HAL_RCC_PWR_CLK_ENABLE();
+    HAL_PWR_EnableBkUpAccess();
+    __HAL_RCC_BKPSRAM_CLK_ENABLE();
+    HAL_PWREx_EnableBkUpReg();   // ݵѹ, Դ VBAT 
+
+    if (!is_hot_start || PERSIST_CNT->magic != PERSIST_CNT_MAGIC)
+    {
+        memset(PERSIST_CNT, 0, sizeof(Persist_Count_t));
+        PERSIST_CNT->magic = PERSIST_CNT_MAGIC;
+    }
+
+    memset(&PersistData, 0, sizeof(PersistData));
+    memset(&persist_stats, 0, sizeof(persist_stats));
+    persist_active = -1;
+    persist_seq = 0;
+    persist_dirty = 0;
+    persist_last = 0;
+    persist_synced[0] = persist_synced[1] = 0;   // һδ֪, һҪд
+    persist_flush_tick = HAL_GetTick();
+
+    if (!is_hot_start) return 0;
+
+    t0 = DWT_CYCCNT_GET();
+    head_a = Persist_Slot_Head_Ok(PERSIST_SLOT(0));
+    head_b = Persist_Slot_Head_Ok(PERSIST_SLOT(1));
+
+    // µǰ; ͷǷֱ
+    order[0] = (head_a && head_b &&
+                (int32_t)(PERSIST_SLOT(1)->seq - PERSIST_SLOT(0)->seq) > 0) ? 1 : 0;
+    if (!head_a) order[0] = 1;
+    order[1] = !order[0];
+
+    for (int i = 0; i < 2; i++)
+    {
+        uint8_t n = order[i];
+        if ((n == 0 ? head_a : head_b) &&
+            PERSIST_SLOT(n)->crc == Persist_Slot_Crc(PERSIST_SLOT(n)))
+        {
+            persist_active = n;
+            break;
+        }
+    }
+    persist_stats.validate_us = DWT_Cycle_To_Us(DWT_CYCCNT_GET() - t0);
+
+    if (persist_active < 0) return 0;
+
+    memcpy(&PersistData, &PERSIST_SLOT(persist_active)->data, sizeof(PersistData));
+    persist_seq = PERSIST_SLOT(persist_active)->seq;
+    persist_synced[persist_active] = 1;
+    persist_stats.seq = persist_seq;
+    return 1;
+}
+
+void Persist_MarkDirty(uint32_t recs)
+{
+    persist_dirty |= recs;
+    PERSIST_CNT->marks++;
+}
+
+/**
+  * @brief ѸĶдһ. ˳:  -> д¼ͷ -> Ч -> CRC,
+  * д CRC һݲ, ;λһ
+  */
+static void Persist_Commit(void)
+{
+    uint8_t next = (persist_active == 0) ? 1 : 0;
+    Persist_Slot_t *slot = PERSIST_SLOT(next);
+    uint32_t recs = persist_synced[next] ? (persist_dirty | persist_last) : PERSIST_REC_ALL;
+
+    slot->magic = 0;   // , дһ븴λʱ϶У鲻
+    __DSB();
+
+    slot->version = PERSIST_VERSION;
+    slot->length = sizeof(Persist_Data_t);
+    slot->seq = persist_seq + 1;
+    for (int i = 0; i < PERSIST_REC_NUM; i++)
+    {
+        if (recs & (1u << i))
+        {
+            memcpy((uint8_t *)&slot->data + persist_rec[i].offset,
+                   (const uint8_t *)&PersistData + persist_rec[i].offset, persist_rec[i].size);
+            PERSIST_CNT->words += persist_rec[i].size / 4;
+        }
+    }
+    slot->magic = PERSIST_MAGIC;
+    __DSB();
+
+    slot->crc = Persist_Slot_Crc(slot);
+    __DSB();
+
+    persist_synced[next] = 1;
+    persist_active = next;
+    persist_seq++;
+    persist_last = persist_dirty;
+    persist_dirty = 0;
+
+    PERSIST_CNT->commits++;
+    PERSIST_CNT->words += 5;    // ͷCRC
+    persist_stats.seq = persist_seq;
+}
+
+uint8_t Persist_Flush(void)
+{
+    persist_flush_tick = HAL_GetTick();
+    if (!persist_dirty) return 0;
+
+    Persist_Commit();
+    return 1;
+}
+
+void Persist_Task(void)
+{
+    if (HAL_GetTick() - persist_flush_tick >= PERSIST_FLUSH_TICKS)
+    {
+        Persist_Flush();
+    }
+}
+
+void Persist_GetStats(Persist_Stats_t *st)
+{
+    *st = persist_stats;
+    st->marks = PERSIST_CNT->marks;
+    st->commits = PERSIST_CNT->commits;
+    st->words = PERSIST_CNT->words;
+}
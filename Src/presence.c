@@ -0,0 +1,169 @@
+#include "presence.h"
+#include "persist.h"
+#include "math.h"
+
+/************************************************************************
+*  (ADC3_IN5, PF7, ⷴ/شŴ)
+*
+* : ֵָ/ (EWMA), ֻ޳ޱ仯ʱ
+* : ˫CUSUM, ƫ볬 K*sigma Ĳۼ,  H_ARRIVE*sigma 
+* 뿪: гʱۼ (K*sigma - |ƫ|),  H_DEPART*sigma 뿪
+*
+* ADC3 ɨ4ͨ, ÿͨ 112+12  ADCCLK(2MHz), вԼ 4kHz,
+* ÿ DMA жһ Presence_Update, ȫΪ O(1) .
+* ϵͳÿ AUTO_RESET_PERIOD λһ, ԻߺۼҪ뱸SRAM.
+* ѧϰҪԼ 250ms, ȸλڻ, ѧһҲҪ,
+* ѧ, ÿθλͷѧ, ԶῪʼ.
+*************************************************************************/
+
+#define PRS_LEARN_SAMPLES  1024              // ѧϰ(Լ250ms)
+#define PRS_ALPHA_LEARN    (1.0f / 64.0f)    // ѧϰ׶ο
+#define PRS_ALPHA          (1.0f / 4096.0f)  // ߸, ʱ䳣Լ1s
+#define PRS_SIGMA_MIN      2.0f              // sigma(LSB), ֹС
+#define PRS_K              3.0f              // Ư (λ: sigma)
+#define PRS_H_ARRIVE       400.0f            // , 10sigmaƫʱԼ15ms
+#define PRS_H_DEPART       2400.0f           // 뿪, صߺԼ200ms
+
+static float prs_mean = 0.0f;
+static float prs_var  = PRS_SIGMA_MIN * PRS_SIGMA_MIN;
+static float prs_s_hi = 0.0f;   // ޳: CUSUM; г: 뿪ۼ
+static float prs_s_lo = 0.0f;   // ޳: CUSUM
+static uint16_t prs_learn_cnt = 0;
+static __IO uint8_t prs_vehicle = 0;
+
+// ¼: жֻд cnt, ѭֻд seen, ж
+static __IO uint32_t prs_arrived_cnt = 0;
+static __IO uint32_t prs_departed_cnt = 0;
+static uint32_t prs_arrived_seen = 0;
+static uint32_t prs_departed_seen = 0;
+
+
+void Presence_Init(uint8_t is_hot_start)
+{
+    Persist_Presence_t *bkp = &PersistData.presence;
+
+    prs_arrived_cnt = prs_arrived_seen = 0;
+    prs_departed_cnt = prs_departed_seen = 0;
+
+    if (is_hot_start && bkp->valid)
+    {
+        // : ָ; λǰûѧĽѧ
+        prs_mean = bkp->mean;
+        prs_var  = bkp->var;
+        prs_s_hi = bkp->s_hi;
+        prs_s_lo = bkp->s_lo;
+        prs_vehicle = bkp->vehicle ? 1 : 0;
+        prs_learn_cnt = (bkp->learn_cnt < PRS_LEARN_SAMPLES) ? bkp->learn_cnt : PRS_LEARN_SAMPLES;
+    }
+    else
+    {
+        prs_mean = 0.0f;
+        prs_var  = PRS_SIGMA_MIN * PRS_SIGMA_MIN;
+        prs_s_hi = prs_s_lo = 0.0f;
+        prs_vehicle = 0;
+        prs_learn_cnt = 0;
+        bkp->valid = 0;
+        Persist_MarkDirty(PERSIST_REC_PRESENCE);
+    }
+}
+
+/**
+  * @brief ѻ (ûѧͬѧ) д PersistData, ɵͳһ Persist_Flush
+  */
+void Presence_Save(void)
+{
+    Persist_Presence_t *bkp = &PersistData.presence;
+
+    __disable_irq();
+    bkp->mean = prs_mean;
+    bkp->var  = prs_var;
+    bkp->s_hi = prs_s_hi;
+    bkp->s_lo = prs_s_lo;
+    bkp->vehicle = prs_vehicle;
+    bkp->learn_cnt = prs_learn_cnt;
+    bkp->valid = 1;
+    __enable_irq();
+
+    Persist_MarkDirty(PERSIST_REC_PRESENCE);
+}
+
+void Presence_Update(uint16_t sample)
+{
+    float x = (float)sample;
+    float d = x - prs_mean;
+    float sigma, k;
+
+    /* ѧϰ׶: ֻٻ,  */
+    if (prs_learn_cnt < PRS_LEARN_SAMPLES)
+    {
+        if (prs_learn_cnt == 0)
+        {
+            prs_mean = x;
+            d = 0.0f;
+        }
+        prs_var = (1.0f - PRS_ALPHA_LEARN) * (prs_var + PRS_ALPHA_LEARN * d * d);
+        prs_mean += PRS_ALPHA_LEARN * d;
+        prs_learn_cnt++;
+        return;
+    }
+
+    sigma = sqrtf(prs_var);  // VSQRT, 14
+    if (sigma < PRS_SIGMA_MIN) sigma = PRS_SIGMA_MIN;
+    k = PRS_K * sigma;
+
+    if (!prs_vehicle)
+    {
+        prs_s_hi += d - k;
+        if (prs_s_hi < 0.0f) prs_s_hi = 0.0f;
+        prs_s_lo += -d - k;
+        if (prs_s_lo < 0.0f) prs_s_lo = 0.0f;
+
+        if (prs_s_hi > PRS_H_ARRIVE * sigma || prs_s_lo > PRS_H_ARRIVE * sigma)
+        {
+            prs_vehicle = 1;
+            prs_s_hi = prs_s_lo = 0.0f;
+            prs_arrived_cnt++;
+        }
+        else if (prs_s_hi == 0.0f && prs_s_lo == 0.0f)
+        {
+            // ûб仯Ÿ», ѳѧ
+            prs_var = (1.0f - PRS_ALPHA) * (prs_var + PRS_ALPHA * d * d);
+            prs_mean += PRS_ALPHA * d;
+        }
+    }
+    else
+    {
+        // г: ص߸(|d| < k)ʱۼ, Լ200msΪ뿪
+        prs_s_hi += k - fabsf(d);
+        if (prs_s_hi < 0.0f) prs_s_hi = 0.0f;
+
+        if (prs_s_hi > PRS_H_DEPART * sigma)
+        {
+            prs_vehicle = 0;
+            prs_s_hi = prs_s_lo = 0.0f;
+            prs_departed_cnt++;
+        }
+    }
+}
+
+Presence_Event_t Presence_GetEvent(void)
+{
+    if (prs_arrived_seen != prs_arrived_cnt)
+    {
+        prs_arrived_seen++;
+        return PRESENCE_EVT_ARRIVED;
+    }
+
+    if (prs_departed_seen != prs_departed_cnt)
+    {
+        prs_departed_seen++;
+        return PRESENCE_EVT_DEPARTED;
+    }
+
+    return PRESENCE_EVT_NONE;
+}
+
+uint8_t Presence_IsVehicle(void)
+{
+    return prs_vehicle;
+}
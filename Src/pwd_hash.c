@@ -0,0 +1,150 @@
+#include "pwd_hash.h"
+#include "kv_store.h"
+#include "rtc.h"
+#include "dwt.h"
+#include "ct_compare.h"
+#include "ct_bench.h"
+#include "entropy.h"
+#include "string.h"
+#include "stdio.h"
+
+/************************************************************************
+* ļժҪ
+*
+* ԭķ Flash ֵͱSRAM, Ӵڴ. 
+* ֻ 16 ֽκ SHA-256( | 8 λ), УʱͬժҪ
+* ٱȽ. ÿ̨豸ͬ (оƬ UID, Ӳ RNG ͵ʱļһϣ), ͬһ
+* ڲͬ豸ϵժҪҲͬ, ûһԤõıȥ.
+*
+* 8 λֻһ, õ Flash ݵ, ժҪ"һۿ
+* "ʹ־й¶; ķٿ.
+*
+* ֵһֵ 16 ֽ, κժҪ: дժҪ, д.
+* ʱڲ, ;ξ͵û. ɰ (KV_KEY_PASSWORD)
+* ʱժҪ, дԺɾ, ;´ο.
+*
+*  16 +  8 ֽ, һ 64 ֽڿ, һѹ. ʱÿζ
+* ,  PWD_VERIFY_BUDGET_US  (HSI 16MHz չԤ 0.2ms ).
+*************************************************************************/
+
+#define PWD_UID_ADDR     0x1FFF7A10u   // 96 λоƬΨһ ID
+
+static Pwd_Stats_t pwd_stats;
+
+
+static void Pwd_New_Salt(uint8_t *salt)
+{
+    Sha256_Ctx_t ctx;
+    uint8_t d[SHA256_DIGEST_LEN];
+    uint32_t mix[8];
+
+    mix[0] = DWT_CYCCNT_GET();
+    mix[1] = HAL_GetTick();
+    mix[2] = RTC_Now();
+    mix[3] = SysTick->VAL;
+    Entropy_Fill((uint8_t *)&mix[4], 16);   // Ӳ RNG 128 λ
+
+    Sha256_Init(&ctx);
+    Sha256_Update(&ctx, (const void *)PWD_UID_ADDR, 12);
+    Sha256_Update(&ctx, mix, sizeof(mix));
+    Sha256_Final(&ctx, d);
+    memcpy(salt, d, PWD_SALT_LEN);
+}
+
+void Pwd_Digest(const Pwd_Hash_t *h, const uint8_t *digits, uint8_t *out)
+{
+    Sha256_Ctx_t ctx;
+    uint32_t t0 = DWT_CYCCNT_GET();
+
+    Sha256_Init(&ctx);
+    Sha256_Update(&ctx, h->salt, PWD_SALT_LEN);
+    Sha256_Update(&ctx, digits, PWD_LEN);
+    Sha256_Final(&ctx, out);
+    memset(&ctx, 0, sizeof(ctx));   // 
+
+    pwd_stats.hash_us = DWT_Cycle_To_Us(DWT_CYCCNT_GET() - t0);
+    if (pwd_stats.hash_us > pwd_stats.hash_max_us) pwd_stats.hash_max_us = pwd_stats.hash_us;
+    if (pwd_stats.hash_us > PWD_VERIFY_BUDGET_US) pwd_stats.over_budget++;
+    pwd_stats.count++;
+}
+
+uint8_t Pwd_Store(Pwd_Hash_t *h, const uint8_t *digits)
+{
+    Pwd_New_Salt(h->salt);
+    Pwd_Digest(h, digits, h->digest);
+
+    return KV_Set(KV_KEY_PWD_DIGEST, h->digest, 16) &&
+           KV_Set(KV_KEY_PWD_DIGEST + 1, h->digest + 16, 16) &&
+           KV_Set(KV_KEY_PWD_SALT, h->salt, PWD_SALT_LEN);
+}
+
+Pwd_Load_t Pwd_Load(Pwd_Hash_t *h, const uint8_t *factory)
+{
+    uint8_t plain[PWD_LEN];
+
+    if (KV_Get(KV_KEY_PASSWORD, plain, PWD_LEN) == PWD_LEN)
+    {
+        if (Pwd_Store(h, plain)) KV_Delete(KV_KEY_PASSWORD);
+        memset(plain, 0, sizeof(plain));
+        return PWD_LOAD_MIGRATED;
+    }
+
+    if (KV_Get(KV_KEY_PWD_SALT, h->salt, PWD_SALT_LEN) == PWD_SALT_LEN &&
+        KV_Get(KV_KEY_PWD_DIGEST, h->digest, 16) == 16 &&
+        KV_Get(KV_KEY_PWD_DIGEST + 1, h->digest + 16, 16) == 16)
+    {
+        return PWD_LOAD_OK;
+    }
+
+    Pwd_Store(h, factory);   // дʧҲ, ´οд
+    return PWD_LOAD_FACTORY;
+}
+
+void Pwd_GetStats(Pwd_Stats_t *st)
+{
+    *st = pwd_stats;
+}
+
+#if PWD_CT_BENCH_ENABLE
+static uint32_t Pwd_Ct_Clock(void)
+{
+    return DWT_CYCCNT_GET();
+}
+
+static void Pwd_Ct_Yield(void)
+{
+    IWDG->KR = IWDG_KEY_RELOAD;
+}
+
+static void Pwd_Ct_Bench_One(const char *name, Ct_Fn_t fn)
+{
+    static Ct_Result_t res;   // 1KB , ջ
+
+    Ct_Bench_Run(&res, fn, SHA256_DIGEST_LEN, PWD_CT_BENCH_SAMPLES, Pwd_Ct_Clock,
+                 DWT_CYCCNT_GET(), Pwd_Ct_Yield);
+
+    printf("\r\n [CT] %s: prefix  n  mean  min  max (cycles)", name);
+    for (uint32_t l = 0; l <= res.len; l++)
+    {
+        const Ct_Acc_t *b = &res.bucket[l];
+        printf("\r\n [CT]   %2u %6u %4u.%02u %4u %4u", l, b->n,
+               (uint32_t)b->mean, (uint32_t)(b->mean * 100) % 100, b->min, b->max);
+    }
+    printf("\r\n [CT] %s: |t| max %u.%02u at prefix %u, dropped %u -> %s", name,
+           (uint32_t)res.t_max, (uint32_t)(res.t_max * 100) % 100, res.t_len, res.dropped,
+           res.t_max > CT_T_THRESHOLD ? "LEAK" : "ok");
+}
+#endif
+
+/**
+  * @brief ϵʱ: ֱȽ㷨һǰ˳ķ,
+  * Ӧ LEAK, ˵ʱ׼
+  */
+void Pwd_Ct_Bench(void)
+{
+#if PWD_CT_BENCH_ENABLE
+    Pwd_Ct_Bench_One("A xor", Ct_Compare_Xor);
+    Pwd_Ct_Bench_One("B sub", Ct_Compare_Sub);
+    Pwd_Ct_Bench_One("early", Ct_Compare_Early);
+#endif
+}
@@ -0,0 +1,240 @@
+/**
+  ******************************************************************************
+  * File Name          : RTC.c
+  * Description        : This file provides code for the configuration
+  *                      of the RTC instances.
+  ******************************************************************************
+  *
+  * COPYRIGHT(c) 2015 STMicroelectronics
+  *
+  * Redistribution and use in source and binary forms, with or without modification,
+  * are permitted provided that the following conditions are met:
+  *   1. Redistributions of source code must retain the above copyright notice,
+  *      this list of conditions and the following disclaimer.
+  *   2. Redistributions in binary form must reproduce the above copyright notice,
+  *      this list of conditions and the following disclaimer in the documentation
+  *      and/or other materials provided with the distribution.
+  *   3. Neither the name of STMicroelectronics nor the names of its contributors
+  *      may be used to endorse or promote products derived from this software
+  *      without specific prior written permission.
+  *
+  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  *
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "rtc.h"
+
+/* USER CODE BEGIN 0 */
+/*
+ * The backup domain (LSE, RTC, BDCR) is not touched by a system reset, and
+ * the board resets itself every few hundred ms. So the calendar is only
+ * initialised once: MX_RTC_Init just switches LSE on and, if the RTC is
+ * already clocked from LSE, resynchronises the shadow registers and leaves
+ * it running. Otherwise RTC_Task waits (non-blocking, the crystal needs
+ * ~2 s on a cold start) for LSERDY and then runs HAL_RTC_Init. The time is
+ * valid once it has been set (INITS, year != 0).
+ */
+static uint8_t rtc_started = 0;
+
+static uint8_t RTC_Clocked_By_LSE(void)
+{
+  return (RCC->BDCR & RCC_BDCR_RTCEN) &&
+         (RCC->BDCR & RCC_BDCR_RTCSEL) == RCC_RTCCLKSOURCE_LSE;
+}
+/* USER CODE END 0 */
+
+RTC_HandleTypeDef hrtc;
+
+/* RTC init function */
+void MX_RTC_Init(void)
+{
+
+  /**Initialize RTC and set the Time and Date 
+  */
+  hrtc.Instance = RTC;
+  hrtc.Init.HourFormat = RTC_HOURFORMAT_24;
+  hrtc.Init.AsynchPrediv = 127;
+  hrtc.Init.SynchPrediv = 255;
+  hrtc.Init.OutPut = RTC_OUTPUT_DISABLE;
+  hrtc.Init.OutPutPolarity = RTC_OUTPUT_POLARITY_HIGH;
+  hrtc.Init.OutPutType = RTC_OUTPUT_TYPE_OPENDRAIN;
+
+  /* USER CODE BEGIN RTC_Init 0 */
+  __HAL_RCC_PWR_CLK_ENABLE();
+  HAL_PWR_EnableBkUpAccess();
+  __HAL_RCC_LSE_CONFIG(RCC_LSE_ON);   /* no wait here, see RTC_Task() */
+
+  rtc_started = 0;
+  if (RTC_Clocked_By_LSE())
+  {
+    /* Still running from before the reset: only wait for RSF so the
+       first read after reset does not return stale shadow registers */
+    hrtc.Lock = HAL_UNLOCKED;
+    hrtc.State = HAL_RTC_STATE_READY;
+    __HAL_RTC_WRITEPROTECTION_DISABLE(&hrtc);
+    HAL_RTC_WaitForSynchro(&hrtc);
+    __HAL_RTC_WRITEPROTECTION_ENABLE(&hrtc);
+    rtc_started = 1;
+  }
+  /* USER CODE END RTC_Init 0 */
+
+}
+
+void HAL_RTC_MspInit(RTC_HandleTypeDef* hrtc)
+{
+
+  if(hrtc->Instance==RTC)
+  {
+  /* USER CODE BEGIN RTC_MspInit 0 */
+
+  /* USER CODE END RTC_MspInit 0 */
+    /* Peripheral clock enable */
+    __HAL_RCC_RTC_ENABLE();
+  /* USER CODE BEGIN RTC_MspInit 1 */
+
+  /* USER CODE END RTC_MspInit 1 */
+  }
+}
+
+void HAL_RTC_MspDeInit(RTC_HandleTypeDef* hrtc)
+{
+
+  if(hrtc->Instance==RTC)
+  {
+  /* USER CODE BEGIN RTC_MspDeInit 0 */
+
+  /* USER CODE END RTC_MspDeInit 0 */
+    /* Peripheral clock disable */
+    __HAL_RCC_RTC_DISABLE();
+  }
+  /* USER CODE BEGIN RTC_MspDeInit 1 */
+
+  /* USER CODE END RTC_MspDeInit 1 */
+} 
+
+/* USER CODE BEGIN 1 */
+
+/**
+  * @brief  Called from the main loop: starts the RTC once LSE is stable.
+  */
+void RTC_Task(void)
+{
+  if (rtc_started || !__HAL_RCC_GET_FLAG(RCC_FLAG_LSERDY)) return;
+
+  /* RTCSEL can only be written once after a backup domain reset */
+  if ((RCC->BDCR & RCC_BDCR_RTCSEL) == 0)
+  {
+    __HAL_RCC_RTC_CONFIG(RCC_RTCCLKSOURCE_LSE);
+  }
+  if (HAL_RTC_Init(&hrtc) == HAL_OK)
+  {
+    rtc_started = 1;
+  }
+}
+
+/**
+  * @brief  Calendar running and set at least once.
+  */
+uint8_t RTC_Calendar_Ready(void)
+{
+  return rtc_started && (RTC->ISR & RTC_ISR_INITS);
+}
+
+uint8_t RTC_Calendar_Get(RTC_Calendar_t *cal)
+{
+  RTC_TimeTypeDef t;
+  RTC_DateTypeDef d;
+
+  if (!RTC_Calendar_Ready()) return 0;
+
+  /* Time first: reading TR locks the shadow DR until it is read */
+  HAL_RTC_GetTime(&hrtc, &t, RTC_FORMAT_BIN);
+  HAL_RTC_GetDate(&hrtc, &d, RTC_FORMAT_BIN);
+
+  cal->year    = 2000 + d.Year;
+  cal->month   = d.Month;
+  cal->day     = d.Date;
+  cal->weekday = d.WeekDay;
+  cal->hour    = t.Hours;
+  cal->minute  = t.Minutes;
+  cal->second  = t.Seconds;
+  return 1;
+}
+
+/**
+  * @brief  Set date and time. The weekday is derived from the date.
+  */
+uint8_t RTC_Calendar_Set(const RTC_Calendar_t *cal)
+{
+  static const uint8_t k[12] = { 0, 3, 2, 5, 0, 3, 5, 1, 4, 6, 2, 4 };
+  RTC_TimeTypeDef t;
+  RTC_DateTypeDef d;
+  uint16_t y;
+  uint8_t wd;
+
+  if (!rtc_started || cal->year < 2000 || cal->year > 2099 ||
+      cal->month < 1 || cal->month > 12 || cal->day < 1 || cal->day > 31 ||
+      cal->hour > 23 || cal->minute > 59 || cal->second > 59) return 0;
+
+  /* Sakamoto: 0 = Sunday */
+  y = cal->year - (cal->month < 3);
+  wd = (y + y / 4 - y / 100 + y / 400 + k[cal->month - 1] + cal->day) % 7;
+
+  t.Hours = cal->hour;
+  t.Minutes = cal->minute;
+  t.Seconds = cal->second;
+  t.SubSeconds = 0;
+  t.TimeFormat = RTC_HOURFORMAT12_AM;
+  t.DayLightSaving = RTC_DAYLIGHTSAVING_NONE;
+  t.StoreOperation = RTC_STOREOPERATION_RESET;
+
+  d.Year = cal->year - 2000;
+  d.Month = cal->month;
+  d.Date = cal->day;
+  d.WeekDay = wd ? wd : RTC_WEEKDAY_SUNDAY;
+
+  return HAL_RTC_SetTime(&hrtc, &t, RTC_FORMAT_BIN) == HAL_OK &&
+         HAL_RTC_SetDate(&hrtc, &d, RTC_FORMAT_BIN) == HAL_OK;
+}
+
+/**
+  * @brief  Seconds since 1970-01-01 00:00 of the local calendar time
+  *         (no time zone), 0 if the clock has not been set.
+  */
+uint32_t RTC_Now(void)
+{
+  RTC_Calendar_t c;
+  uint32_t y, m, days;
+
+  if (!RTC_Calendar_Get(&c)) return 0;
+
+  /* days from civil date, March based year */
+  y = c.year - (c.month <= 2);
+  m = (c.month + 9) % 12;
+  days = 365 * y + y / 4 - y / 100 + y / 400 + (153 * m + 2) / 5 + c.day - 1 - 719468;
+
+  return days * 86400u + c.hour * 3600u + c.minute * 60u + c.second;
+}
+
+/* USER CODE END 1 */
+
+/**
+  * @}
+  */
+
+/**
+  * @}
+  */
+
+/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -0,0 +1,627 @@
+#include "servo.h"
+#include "persist.h"
+#include "kv_store.h"
+#include "tim.h"
+#include "dwt.h"
+#include "arm_math.h"
+
+/************************************************************************
+* ջλÿ + ˶
+*
+*  = TIM12 PWM  (20ms). CCR1 Ԥװ, һֻЧһ
+* Ƚֵ, ڸжһڵ, Ƶʹ̶ 50Hz.
+*
+*  = Ŀֵ(ǰ) + PID . ĿԶʱֻǰ, PID 㲻,
+* ٶתȥ;  SERVO_PID_WINDOW ڲ PID 
+* ɵľ, ȿֱֲͶ.
+*
+* ˶: Servo_Set һѱȽֵ 600  2400 (ײ, Դ
+* ), һ/Sι켣, ÿPWMһȽֵ,  DMA 
+* д TIM12->CCR1. TIM12 û DMA , Խͬʱͬڵ TIM7,
+* ¼ DMA1_Stream2 (ͨ1). TIM7 µ PWM м,
+* дֵһ TIM12 ʱЧ, һǡһֵ. ŶӺȫ
+* Ҫ CPU ; ڼжֻ, л ǰ + PID յ.
+*
+* λ ADC  (Լ4kHz) һ׵ͨ, Ի(us).
+*
+* ת/ obstruct.c ж Servo_Obstruct_ISR: բ;
+* բ, բ;о͵ͣס. TIM12 жֻص DMA բڵǰ
+* λ (),  (, arm_sin_f32)  HAL_DMA_Abort ĵȴ
+* ҵȼ PendSV , жϷغִ, ѭ.
+* ѭȡ SERVO_EVT_OBSTRUCTED ֮ǰ, Servo_Set Ŀ, ֹѭ
+* ְբ.
+*
+* AUTO_RESET_PERIOD ϽϳĶ (S߹ٶξҪ 300ms ):
+* Servo_Save ͣڵǰȽֵ, ͬߵ, յͲڼֵ
+* SRAM. ͬĲͬһ, DMA ӶϵŲ, ٶ
+* ÿθλ¼.
+*************************************************************************/
+
+#define SERVO_PULSE_MIN        500
+#define SERVO_PULSE_MAX        2500
+
+// λ궨: բ/բλöӦ ADC 
+#define SERVO_FB_ADC_CLOSE     410
+#define SERVO_FB_ADC_OPEN      3686
+
+#define SERVO_PID_KP           0.30f
+#define SERVO_PID_KI           0.05f
+#define SERVO_PID_KD           0.0f
+#define SERVO_PID_WINDOW       150.0f   // СڴֵPID (us)
+#define SERVO_TRIM_MAX         200.0f   // PID޷ (us)
+
+#define SERVO_SETTLE_TOL       20       // λ (us)
+#define SERVO_SETTLE_PERIODS   3        // 3㵽λ
+#define SERVO_STALL_WINDOW     10       // ÿ200msһǷڶ
+#define SERVO_STALL_DELTA      15       // 200msƶСڴֵ㿨ס (us)
+#define SERVO_TIMEOUT_PERIODS  100      // ߲ 2s ûλ㳬ʱ
+
+#define SERVO_PROFILE_MAX_LEN  256      // ߻,  5.12s
+#define SERVO_DEF_MAX_VEL      60       // 3000us/s, ȫԼ 0.9s
+#define SERVO_DEF_ACCEL        6        // ֵٶ, Լ 200ms ӵٶ
+
+static __IO uint16_t servo_target = SERVO_CLOSE;
+static uint16_t servo_cmd = SERVO_CLOSE;
+static uint16_t servo_pos = 0;
+static uint16_t servo_move_periods = 0;
+static __IO uint32_t servo_isr_last = 0;
+static __IO uint32_t servo_isr_max = 0;
+static uint8_t servo_ready = 0;           // Servo_Init ֮ǰֻ¼Ŀ
+
+static Servo_Profile_t servo_profile = { SERVO_PROFILE_SCURVE, SERVO_DEF_MAX_VEL, SERVO_DEF_ACCEL };
+static uint16_t servo_profile_buf[SERVO_PROFILE_MAX_LEN];
+static __IO uint16_t servo_profile_len = 0;
+static __IO uint8_t servo_streaming = 0;  // 1: CCR1 /DMA , жϲд
+static __IO uint8_t servo_planning = 0;   // 1: ѭ¹滮
+static __IO int8_t servo_move_dir = 0;    // ζ
+static uint16_t servo_move_from = 0;      // ߵ, λ
+
+static __IO uint8_t servo_obstructed = 0;       // ת, ѭȡ¼
+static __IO uint16_t servo_reverse_pending = 0; // 滮ڼ⵽ת, 滮ٷ
+
+#if SERVO_FEEDBACK_ENABLE
+static arm_pid_instance_f32 servo_pid;
+static __IO uint32_t servo_fb_filt = 0;   // ͨ ADC ֵ (Q4)
+static __IO uint8_t  servo_fb_valid = 0;
+
+static uint16_t servo_active_target = 0;  // 0: ûʼһζ
+static uint8_t  servo_move_done = 1;
+static uint8_t  servo_settle_cnt = 0;
+static uint16_t servo_stall_ref = 0;
+static uint16_t servo_stall_cmd_ref = 0;
+#endif
+
+static __IO uint8_t servo_evt = SERVO_EVT_NONE;
+
+static void Servo_Move(uint16_t pwm);
+
+
+static uint16_t Servo_Clamp(int32_t pwm)
+{
+    if (pwm < SERVO_PULSE_MIN) return SERVO_PULSE_MIN;
+    if (pwm > SERVO_PULSE_MAX) return SERVO_PULSE_MAX;
+    return (uint16_t)pwm;
+}
+
+/**
+  * @brief Ӿֹʼ t ߹ľ
+  * : ȼ; S: ٶȰ v(t) = v/2 * (1 - cos(pi*t/ta))
+  */
+static float32_t Servo_Ramp_Dist(float32_t t, float32_t v, float32_t ta)
+{
+    if (servo_profile.shape == SERVO_PROFILE_SCURVE)
+        return 0.5f * v * (t - ta / PI * arm_sin_f32(PI * t / ta));
+
+    return 0.5f * v * t * t / ta;
+}
+
+/**
+  * @brief  from -> to ˶, ÿPWMһȽֵ
+  * @retval ߳ (), 0 ʾĿλ
+  */
+static uint16_t Servo_Profile_Build(uint16_t from, uint16_t to)
+{
+    float32_t dist = (to > from) ? (float32_t)(to - from) : (float32_t)(from - to);
+    float32_t v = servo_profile.max_vel;
+    float32_t a = servo_profile.accel;
+    // ʱ ta = k*v/a. ҵķֵٶƽֵ pi/2 , ֵ޼ٶ
+    float32_t k = (servo_profile.shape == SERVO_PROFILE_SCURVE) ? (PI / 2.0f) : 1.0f;
+    float32_t ta, tc, total, step = 1.0f;
+    uint16_t len;
+
+    if (from == to) return 0;
+
+    ta = k * v / a;
+    if (v * ta > dist)
+    {
+        // ̵̫ٶ, ûٶ: k*v^2/a = dist
+        v = sqrtf(dist * a / k);
+        ta = k * v / a;
+    }
+    tc = (dist - v * ta) / v;
+    total = 2.0f * ta + tc;
+
+    len = (uint16_t)total;
+    if (len < total) len++;
+    if (len > SERVO_PROFILE_MAX_LEN)
+    {
+        // ̫Ų, ѹʱ
+        step = total / SERVO_PROFILE_MAX_LEN;
+        len = SERVO_PROFILE_MAX_LEN;
+    }
+
+    for (uint16_t i = 0; i < len; i++)
+    {
+        float32_t t = (i + 1) * step;
+        float32_t s;
+        int32_t ds;
+
+        if (t >= total)         s = dist;
+        else if (t < ta)        s = Servo_Ramp_Dist(t, v, ta);
+        else if (t < ta + tc)   s = 0.5f * v * ta + v * (t - ta);
+        else                    s = dist - Servo_Ramp_Dist(total - t, v, ta);
+
+        ds = (int32_t)(s + 0.5f);
+        servo_profile_buf[i] = Servo_Clamp((to > from) ? (int32_t)from + ds : (int32_t)from - ds);
+    }
+    servo_profile_buf[len - 1] = to;
+
+    return len;
+}
+
+static void Servo_Stream_Stop(void)
+{
+    __HAL_TIM_DISABLE_DMA(&htim7, TIM_DMA_UPDATE);
+    HAL_DMA_Abort(htim7.hdma[TIM_DMA_ID_UPDATE]);
+}
+
+static void Servo_Stream_Start(uint16_t first, uint16_t len)
+{
+    DMA_HandleTypeDef *hdma = htim7.hdma[TIM_DMA_ID_UPDATE];
+
+    // һµı־, ʹܲ
+    __HAL_DMA_CLEAR_FLAG(hdma, __HAL_DMA_GET_TC_FLAG_INDEX(hdma) | __HAL_DMA_GET_HT_FLAG_INDEX(hdma) |
+                               __HAL_DMA_GET_TE_FLAG_INDEX(hdma) | __HAL_DMA_GET_FE_FLAG_INDEX(hdma) |
+                               __HAL_DMA_GET_DME_FLAG_INDEX(hdma));
+    HAL_DMA_Start(hdma, (uint32_t)&servo_profile_buf[first], (uint32_t)&htim12.Instance->CCR1, len - first);
+
+    // ſ TIM7  DMA , һֵһ TIM7 (PWM м)д
+    __HAL_TIM_ENABLE_DMA(&htim7, TIM_DMA_UPDATE);
+}
+
+/**
+  * @brief Ƿڲ. ͨģʽһݴ, ӲԶر
+  */
+static uint8_t Servo_Stream_Poll(void)
+{
+    if (servo_streaming && !servo_planning &&
+        (htim7.hdma[TIM_DMA_ID_UPDATE]->Instance->CR & DMA_SxCR_EN) == 0)
+    {
+        __HAL_TIM_DISABLE_DMA(&htim7, TIM_DMA_UPDATE);
+        servo_streaming = 0;
+    }
+    return servo_streaming;
+}
+
+/**
+  * @brief 滮. 滮ڼתҪķﲹ
+  */
+static void Servo_Planning_End(void)
+{
+    uint16_t rev;
+
+    servo_planning = 0;
+
+    __disable_irq();
+    rev = servo_reverse_pending;
+    servo_reverse_pending = 0;
+    __enable_irq();
+
+    if (rev)
+    {
+        Servo_Move(rev);
+    }
+}
+
+/**
+  * @brief ӵǰλù滮һ pwm ߲ʼ
+  */
+static void Servo_Move(uint16_t pwm)
+{
+    uint16_t from, len;
+
+    // 滮ڼжϲ CCR1
+    servo_planning = 1;
+    servo_streaming = 1;
+    Servo_Stream_Stop();
+
+    // ʵıȽֵ (һߵİ·)
+    from = (uint16_t)__HAL_TIM_GET_COMPARE(&htim12, TIM_CHANNEL_1);
+    servo_target = pwm;
+    servo_move_from = from;
+
+    len = Servo_Profile_Build(from, Servo_Clamp(pwm));
+    servo_profile_len = len;
+    if (len > 0)
+    {
+        servo_move_dir = (Servo_Clamp(pwm) > from) ? 1 : -1;
+        Servo_Stream_Start(0, len);
+    }
+
+    Servo_Planning_End();
+}
+
+/**
+  * @brief : λǰڲ߰ԭյ, ӶϵŲ.
+  * Ŀ˻Ѿ귵 0, ɵ÷¹滮
+  */
+static uint8_t Servo_Resume(const Persist_Servo_t *bkp)
+{
+    uint16_t len;
+
+    if (bkp->move_idx == 0 || bkp->move_to != Servo_Clamp(servo_target)) return 0;
+
+    servo_planning = 1;
+    servo_streaming = 1;
+    len = Servo_Profile_Build(bkp->move_from, bkp->move_to);
+    if (bkp->move_idx >= len)
+    {
+        servo_streaming = 0;
+        servo_planning = 0;
+        return 0;
+    }
+
+    servo_move_from = bkp->move_from;
+    servo_profile_len = len;
+    servo_move_dir = (bkp->move_to > bkp->move_from) ? 1 : -1;
+    Servo_Stream_Start(bkp->move_idx, len);
+    Servo_Planning_End();
+    return 1;
+}
+
+void Servo_Init(uint8_t is_hot_start)
+{
+    Persist_Servo_t *bkp = &PersistData.servo;
+    uint16_t start;
+
+#if SERVO_FEEDBACK_ENABLE
+    servo_pid.Kp = SERVO_PID_KP;
+    servo_pid.Ki = SERVO_PID_KI;
+    servo_pid.Kd = SERVO_PID_KD;
+    arm_pid_init_f32(&servo_pid, 1);
+    servo_active_target = 0;
+    servo_move_done = 1;
+#endif
+    servo_evt = SERVO_EVT_NONE;
+    servo_isr_max = 0;
+    HAL_NVIC_SetPriority(PendSV_IRQn, 3, 3);   // תķ滮, ж϶
+
+    // : ָ߲͸λǰλ, ûĶ
+    if (is_hot_start && bkp->valid)
+    {
+        Servo_Profile_t p;
+        p.shape   = bkp->shape;
+        p.max_vel = bkp->max_vel;
+        p.accel   = bkp->accel;
+        Servo_SetProfile(&p);
+        start = Servo_Clamp(bkp->position);
+    }
+    else
+    {
+        Servo_Profile_t p;
+        if (KV_Get(KV_KEY_SERVO_PROFILE, &p, sizeof(p)) == sizeof(p))
+        {
+            Servo_SetProfile(&p);            // ϵǰù߲
+        }
+        start = Servo_Clamp(servo_target);   // ֪, ֱֻӸĿ
+    }
+
+    // дȽֵٿPWM, ֹһĬ
+    servo_cmd = start;
+    __HAL_TIM_SetCompare(&htim12, TIM_CHANNEL_1, servo_cmd);
+    HAL_TIM_PWM_Start(&htim12, TIM_CHANNEL_1);
+    HAL_TIM_Base_Start_IT(&htim12);
+
+    // TIM7  TIM12 ͬһʱͬһ,  TIM7 ĸµŵ PWM м
+    __HAL_TIM_SET_COUNTER(&htim7, (__HAL_TIM_GET_COUNTER(&htim12) + (htim12.Init.Period + 1) / 2)
+                                  % (htim12.Init.Period + 1));
+    HAL_TIM_Base_Start(&htim7);
+
+    servo_ready = 1;
+    if (!(is_hot_start && bkp->valid && Servo_Resume(bkp)))
+    {
+        Servo_Move(servo_target);
+    }
+}
+
+/**
+  * @brief λǰ: ͣס, ѵǰλ, ߲ͲŽд PersistData
+  * servo_planning Ϊ 1, λǰжϲٸĶ CCR1
+  */
+void Servo_Save(void)
+{
+    Persist_Servo_t *bkp = &PersistData.servo;
+    uint16_t idx = 0;
+
+    if (servo_ready)
+    {
+        uint8_t playing = servo_streaming && !servo_planning;
+
+        servo_planning = 1;
+        servo_streaming = 1;
+        Servo_Stream_Stop();
+
+        // ֮ͣ NDTR ǻûдȥĸ; ѾΪ 0, ýŲ
+        if (playing && servo_profile_len > 0)
+        {
+            idx = servo_profile_len - (uint16_t)htim7.hdma[TIM_DMA_ID_UPDATE]->Instance->NDTR;
+            if (idx >= servo_profile_len) idx = 0;
+        }
+    }
+
+    bkp->move_from = servo_move_from;
+    bkp->move_to   = Servo_Clamp(servo_target);
+    bkp->move_idx  = idx;
+    bkp->position = (uint16_t)__HAL_TIM_GET_COMPARE(&htim12, TIM_CHANNEL_1);
+    bkp->shape    = servo_profile.shape;
+    bkp->max_vel  = servo_profile.max_vel;
+    bkp->accel    = servo_profile.accel;
+    bkp->valid    = 1;
+    Persist_MarkDirty(PERSIST_REC_SERVO);
+}
+
+/**
+  * @brief 趨Ŀλ. ӵǰλð˶߹ȥ, ڲŵ߱¹滮
+  * ѭᷴͬһĿ, Ŀ겻ʱʲôҲ
+  */
+void Servo_Set(uint16_t pwm)
+{
+    if (pwm == servo_target) return;
+
+    if (!servo_ready)
+    {
+        // ָӲʱ Servo_Init û, ȼĿ
+        servo_target = pwm;
+        return;
+    }
+
+    // ռס滮Ȩټ: ֮⵽Ķת servo_reverse_pending
+    servo_planning = 1;
+    if (servo_obstructed)
+    {
+        Servo_Planning_End();
+        return;
+    }
+
+    Servo_Move(pwm);
+}
+
+/**
+  * @brief ת,  TIM12 ж obstruct.c .
+  * ֻ (CCR1 ֵǰֵ),  PendSV  Servo_Replan_ISR
+  */
+void Servo_Obstruct_ISR(void)
+{
+    uint16_t now = (uint16_t)__HAL_TIM_GET_COMPARE(&htim12, TIM_CHANNEL_1);
+    uint16_t rev = (servo_move_dir < 0) ? SERVO_OPEN : now;
+
+    servo_obstructed = 1;
+    servo_evt = SERVO_EVT_OBSTRUCTED;
+    if (rev == now) servo_move_dir = 0;   // ͵ͣס㶯, תж
+
+    servo_reverse_pending = rev;
+    if (servo_planning) return;   // ڹ滮, ܶ DMA, 滮 Servo_Planning_End ﷴ
+
+    // ص TIM7  DMA ߾ͣ,  Servo_Move ȥ Abort.
+    // ռס滮Ȩ, жϲ CCR1
+    servo_planning = 1;
+    servo_streaming = 1;
+    __HAL_TIM_DISABLE_DMA(&htim7, TIM_DMA_UPDATE);
+    SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+}
+
+/**
+  * @brief PendSV е:  Servo_Obstruct_ISR 滮
+  */
+void Servo_Replan_ISR(void)
+{
+    Servo_Planning_End();
+}
+
+/**
+  * @brief ڶķ. ߲굫ûλҲڶ
+  */
+int8_t Servo_Motion_Dir(void)
+{
+    if (servo_streaming) return servo_move_dir;
+#if SERVO_FEEDBACK_ENABLE
+    if (!servo_move_done) return servo_move_dir;
+#endif
+    return 0;
+}
+
+/**
+  * @brief ޸˶߲, һζЧ
+  */
+void Servo_SetProfile(const Servo_Profile_t *p)
+{
+    servo_profile.shape   = (p->shape == SERVO_PROFILE_SCURVE) ? SERVO_PROFILE_SCURVE : SERVO_PROFILE_TRAPEZOID;
+    servo_profile.max_vel = (p->max_vel > 0) ? p->max_vel : 1;
+    servo_profile.accel   = (p->accel > 0) ? p->accel : 1;
+    KV_Set(KV_KEY_SERVO_PROFILE, &servo_profile, sizeof(servo_profile));   // ֵû䲻д
+}
+
+void Servo_GetProfile(Servo_Profile_t *p)
+{
+    *p = servo_profile;
+}
+
+void Servo_Feedback(uint16_t adc)
+{
+#if SERVO_FEEDBACK_ENABLE
+    // һ׵ͨ (alpha = 1/8), Q4 
+    if (!servo_fb_valid)
+    {
+        servo_fb_filt = (uint32_t)adc << 4;
+        servo_fb_valid = 1;
+    }
+    else
+    {
+        servo_fb_filt += (int32_t)(((uint32_t)adc << 4) - servo_fb_filt) >> 3;
+    }
+#endif
+}
+
+#if SERVO_FEEDBACK_ENABLE
+// ת¼ûѭȡǰܱ
+static void Servo_Report(Servo_Event_t evt)
+{
+    if (servo_evt != SERVO_EVT_OBSTRUCTED) servo_evt = evt;
+}
+
+static uint16_t Servo_Fb_To_Pulse(uint32_t fb_q4)
+{
+    int32_t adc = (int32_t)(fb_q4 >> 4);
+    int32_t pulse = SERVO_CLOSE + (adc - SERVO_FB_ADC_CLOSE) * (SERVO_OPEN - SERVO_CLOSE)
+                                  / (SERVO_FB_ADC_OPEN - SERVO_FB_ADC_CLOSE);
+    return Servo_Clamp(pulse);
+}
+
+static void Servo_Supervise(float32_t err, uint8_t streaming)
+{
+    uint16_t abs_err = (uint16_t)fabsf(err);
+
+    if (servo_move_done) return;
+
+    servo_move_periods++;
+
+    if (abs_err <= SERVO_SETTLE_TOL)
+    {
+        if (++servo_settle_cnt >= SERVO_SETTLE_PERIODS)
+        {
+            Servo_Report(SERVO_EVT_SETTLED);
+            servo_move_done = 1;
+        }
+        return;
+    }
+    servo_settle_cnt = 0;
+
+    // ԶĿʱпס, Ŀ긽 PID.
+    // ָ߲ߵúʱ(ٲ)
+    if (abs_err > SERVO_PID_WINDOW && (servo_move_periods % SERVO_STALL_WINDOW) == 0)
+    {
+        int32_t moved = (int32_t)servo_pos - (int32_t)servo_stall_ref;
+        int32_t cmd_moved = (int32_t)servo_cmd - (int32_t)servo_stall_cmd_ref;
+        if (moved < 0) moved = -moved;
+        if (cmd_moved < 0) cmd_moved = -cmd_moved;
+        servo_stall_ref = servo_pos;
+        servo_stall_cmd_ref = servo_cmd;
+
+        if (moved < SERVO_STALL_DELTA && (!streaming || cmd_moved >= 2 * SERVO_STALL_DELTA))
+        {
+            Servo_Report(SERVO_EVT_STALLED);
+            servo_move_done = 1;
+            return;
+        }
+    }
+
+    if (servo_move_periods >= SERVO_TIMEOUT_PERIODS + servo_profile_len)
+    {
+        Servo_Report(SERVO_EVT_TIMEOUT);
+        servo_move_done = 1;
+    }
+}
+#endif
+
+/**
+  * @brief ж,  TIM12 ¼(ÿPWMڿʼ)ʱִ
+  */
+void Servo_Ctrl_ISR(void)
+{
+    uint32_t t0 = DWT_CYCCNT_GET();
+    uint16_t target = servo_target;
+    uint8_t streaming = Servo_Stream_Poll();
+
+#if SERVO_FEEDBACK_ENABLE
+    if (servo_fb_valid)
+    {
+        float32_t err, trim = 0.0f;
+
+        servo_pos = Servo_Fb_To_Pulse(servo_fb_filt);
+        err = (float32_t)target - (float32_t)servo_pos;
+
+        // Ŀ: ʼһζ. ѾĿλõ()㶯, ¼
+        if (target != servo_active_target)
+        {
+            servo_active_target = target;
+            servo_move_periods = 0;
+            servo_settle_cnt = 0;
+            servo_stall_ref = servo_pos;
+            servo_stall_cmd_ref = (uint16_t)__HAL_TIM_GET_COMPARE(&htim12, TIM_CHANNEL_1);
+            servo_move_done = (fabsf(err) <= SERVO_SETTLE_TOL);
+            arm_pid_reset_f32(&servo_pid);
+        }
+
+        if (streaming)
+        {
+            // ߲ CCR1  DMA, ֻ
+            arm_pid_reset_f32(&servo_pid);
+            servo_cmd = (uint16_t)__HAL_TIM_GET_COMPARE(&htim12, TIM_CHANNEL_1);
+        }
+        else
+        {
+            if (fabsf(err) > SERVO_PID_WINDOW)
+            {
+                arm_pid_reset_f32(&servo_pid);
+            }
+            else
+            {
+                trim = arm_pid_f32(&servo_pid, err);
+                if (trim > SERVO_TRIM_MAX) trim = SERVO_TRIM_MAX;
+                if (trim < -SERVO_TRIM_MAX) trim = -SERVO_TRIM_MAX;
+                servo_pid.state[2] = trim;   // ֱ
+            }
+            servo_cmd = Servo_Clamp((int32_t)target + (int32_t)trim);
+        }
+
+        Servo_Supervise(err, streaming);
+    }
+    else
+#endif
+    {
+        servo_cmd = streaming ? (uint16_t)__HAL_TIM_GET_COMPARE(&htim12, TIM_CHANNEL_1)
+                              : Servo_Clamp(target);
+    }
+
+    if (!streaming)
+    {
+        __HAL_TIM_SetCompare(&htim12, TIM_CHANNEL_1, servo_cmd);
+    }
+
+    servo_isr_last = DWT_CYCCNT_GET() - t0;
+    if (servo_isr_last > servo_isr_max) servo_isr_max = servo_isr_last;
+}
+
+Servo_Event_t Servo_GetEvent(void)
+{
+    Servo_Event_t evt;
+
+    __disable_irq();
+    evt = (Servo_Event_t)servo_evt;
+    servo_evt = SERVO_EVT_NONE;
+    if (evt == SERVO_EVT_OBSTRUCTED) servo_obstructed = 0;   // ѭ֪, 
+    __enable_irq();
+
+    return evt;
+}
+
+void Servo_GetStats(Servo_Stats_t *st)
+{
+    st->target = servo_target;
+    st->position = servo_pos;
+    st->command = servo_cmd;
+    st->move_periods = servo_move_periods;
+    st->profile_periods = servo_profile_len;
+    st->isr_last_cycles = servo_isr_last;
+    st->isr_max_cycles = servo_isr_max;
+}
@@ -0,0 +1,97 @@
+#include "sha1.h"
+
+/************************************************************************
+* SHA-1 ѹ (FIPS 180-4)
+*
+* ֻ HMAC-SHA1 (totp.c) . HMAC 鶼ǳԼƴ, ֱӰִ,
+* ûֽת, ҲûͨõĻ/߼.
+*
+* չ (SHA1_UNROLL=1) д sha256.c һ: 80 ȫչ, ״̬
+* ֻ, Ϣչ 16 ֻ, ±궼ǳ.
+*************************************************************************/
+
+#define ROL(x, n)       (((x) << (n)) | ((x) >> (32 - (n))))
+#define F0(b, c, d)     ((d) ^ ((b) & ((c) ^ (d))))          // 0~19: Ch
+#define F1(b, c, d)     ((b) ^ (c) ^ (d))                     // 20~39, 60~79: Parity
+#define F2(b, c, d)     (((b) & (c)) | ((d) & ((b) | (c))))   // 40~59: Maj
+
+#define K0  0x5A827999u
+#define K1  0x6ED9EBA1u
+#define K2  0x8F1BBCDCu
+#define K3  0xCA62C1D6u
+
+void Sha1_Init(uint32_t *state)
+{
+    state[0] = 0x67452301u;
+    state[1] = 0xEFCDAB89u;
+    state[2] = 0x98BADCFEu;
+    state[3] = 0x10325476u;
+    state[4] = 0xC3D2E1F0u;
+}
+
+#if SHA1_UNROLL
+
+#define W(i)    ((i) < 16 ? x[(i)] : \
+                 (x[(i) & 15] = ROL(x[((i) - 3) & 15] ^ x[((i) - 8) & 15] ^ \
+                                    x[((i) - 14) & 15] ^ x[(i) & 15], 1)))
+
+#define ROUND(a, b, c, d, e, F, K, i)                       \
+    do {                                                    \
+        (e) += ROL(a, 5) + F(b, c, d) + (K) + W(i);         \
+        (b) = ROL(b, 30);                                   \
+    } while (0)
+
+#define ROUND5(F, K, i)                     \
+    ROUND(a, b, c, d, e, F, K, (i) + 0);    \
+    ROUND(e, a, b, c, d, F, K, (i) + 1);    \
+    ROUND(d, e, a, b, c, F, K, (i) + 2);    \
+    ROUND(c, d, e, a, b, F, K, (i) + 3);    \
+    ROUND(b, c, d, e, a, F, K, (i) + 4)
+
+void Sha1_Block(uint32_t *state, const uint32_t *w)
+{
+    uint32_t x[16];
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+
+    x[0]  = w[0];  x[1]  = w[1];  x[2]  = w[2];  x[3]  = w[3];
+    x[4]  = w[4];  x[5]  = w[5];  x[6]  = w[6];  x[7]  = w[7];
+    x[8]  = w[8];  x[9]  = w[9];  x[10] = w[10]; x[11] = w[11];
+    x[12] = w[12]; x[13] = w[13]; x[14] = w[14]; x[15] = w[15];
+
+    ROUND5(F0, K0, 0);  ROUND5(F0, K0, 5);  ROUND5(F0, K0, 10); ROUND5(F0, K0, 15);
+    ROUND5(F1, K1, 20); ROUND5(F1, K1, 25); ROUND5(F1, K1, 30); ROUND5(F1, K1, 35);
+    ROUND5(F2, K2, 40); ROUND5(F2, K2, 45); ROUND5(F2, K2, 50); ROUND5(F2, K2, 55);
+    ROUND5(F1, K3, 60); ROUND5(F1, K3, 65); ROUND5(F1, K3, 70); ROUND5(F1, K3, 75);
+
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d; state[4] += e;
+}
+
+#else
+
+void Sha1_Block(uint32_t *state, const uint32_t *w)
+{
+    uint32_t x[16];
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+
+    for (int i = 0; i < 80; i++)
+    {
+        uint32_t f, t;
+
+        if (i < 16)
+            x[i] = w[i];
+        else
+            x[i & 15] = ROL(x[(i - 3) & 15] ^ x[(i - 8) & 15] ^ x[(i - 14) & 15] ^ x[i & 15], 1);
+
+        if (i < 20)      f = F0(b, c, d) + K0;
+        else if (i < 40) f = F1(b, c, d) + K1;
+        else if (i < 60) f = F2(b, c, d) + K2;
+        else             f = F1(b, c, d) + K3;
+
+        t = ROL(a, 5) + f + e + x[i & 15];
+        e = d; d = c; c = ROL(b, 30); b = a; a = t;
+    }
+
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d; state[4] += e;
+}
+
+#endif /* SHA1_UNROLL */
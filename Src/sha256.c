@@ -0,0 +1,184 @@
+#include "sha256.h"
+#include <string.h>
+
+/************************************************************************
+* SHA-256 (FIPS 180-4)
+*
+* ֻ stdint/string, Ҳֱӱ. ѹ汾:
+*
+*  չ (SHA256_UNROLL=1, Cortex-M4 Ĭ): 64 ȫչ, a~h ,
+*  ÿֻ˳; Ϣչֻ 16 ֵĻ w[], ±ȫ
+*  , ǵֲͨĴ (ŲµĲŽջ), 
+*  64 ֵ W . ѭλд (x >> n) | (x << (32-n)),  ROR,
+*  M4 ͰλֱܰӲ EOR ĵڶ,  ÿֻҪ
+*  ָ. ȡ REV. Լ 4KB.
+*
+*  ѭ (SHA256_UNROLL=0): ͬ 16 ִ, ѭ, С, .
+*
+* Žֻһ ( 16 ֽ + 8 λ + ), ʱ pwd_hash.c.
+*************************************************************************/
+
+#define ROR(x, n)       (((x) >> (n)) | ((x) << (32 - (n))))
+#define CH(x, y, z)     (((x) & (y)) ^ (~(x) & (z)))
+#define MAJ(x, y, z)    (((x) & (y)) | ((z) & ((x) | (y))))
+#define EP0(x)          (ROR(x, 2) ^ ROR(x, 13) ^ ROR(x, 22))
+#define EP1(x)          (ROR(x, 6) ^ ROR(x, 11) ^ ROR(x, 25))
+#define SIG0(x)         (ROR(x, 7) ^ ROR(x, 18) ^ ((x) >> 3))
+#define SIG1(x)         (ROR(x, 17) ^ ROR(x, 19) ^ ((x) >> 10))
+
+#if defined(__CC_ARM)
+#define LOAD_BE32(p)    __rev(*(const __packed uint32_t *)(p))
+#else
+#define LOAD_BE32(p)    (((uint32_t)(p)[0] << 24) | ((uint32_t)(p)[1] << 16) | \
+                         ((uint32_t)(p)[2] << 8) | (uint32_t)(p)[3])
+#endif
+
+static const uint32_t sha256_k[64] =
+{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+#if SHA256_UNROLL
+
+//  i õϢ: ǰ 16 ֱȡ, ֮͵չ (i ǳ, жϱʱͶ)
+#define W(i)    ((i) < 16 ? w[(i)] : \
+                 (w[(i) & 15] += SIG1(w[((i) - 2) & 15]) + w[((i) - 7) & 15] + SIG0(w[((i) - 15) & 15])))
+
+#define ROUND(a, b, c, d, e, f, g, h, i)                           \
+    do {                                                           \
+        uint32_t t = (h) + EP1(e) + CH(e, f, g) + sha256_k[i] + W(i); \
+        (d) += t;                                                  \
+        (h) = t + EP0(a) + MAJ(a, b, c);                           \
+    } while (0)
+
+#define ROUND8(i)                                   \
+    ROUND(a, b, c, d, e, f, g, h, (i) + 0);         \
+    ROUND(h, a, b, c, d, e, f, g, (i) + 1);         \
+    ROUND(g, h, a, b, c, d, e, f, (i) + 2);         \
+    ROUND(f, g, h, a, b, c, d, e, (i) + 3);         \
+    ROUND(e, f, g, h, a, b, c, d, (i) + 4);         \
+    ROUND(d, e, f, g, h, a, b, c, (i) + 5);         \
+    ROUND(c, d, e, f, g, h, a, b, (i) + 6);         \
+    ROUND(b, c, d, e, f, g, h, a, (i) + 7)
+
+static void Sha256_Block(uint32_t *state, const uint8_t *p)
+{
+    uint32_t w[16];
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+    w[0]  = LOAD_BE32(p);      w[1]  = LOAD_BE32(p + 4);
+    w[2]  = LOAD_BE32(p + 8);  w[3]  = LOAD_BE32(p + 12);
+    w[4]  = LOAD_BE32(p + 16); w[5]  = LOAD_BE32(p + 20);
+    w[6]  = LOAD_BE32(p + 24); w[7]  = LOAD_BE32(p + 28);
+    w[8]  = LOAD_BE32(p + 32); w[9]  = LOAD_BE32(p + 36);
+    w[10] = LOAD_BE32(p + 40); w[11] = LOAD_BE32(p + 44);
+    w[12] = LOAD_BE32(p + 48); w[13] = LOAD_BE32(p + 52);
+    w[14] = LOAD_BE32(p + 56); w[15] = LOAD_BE32(p + 60);
+
+    ROUND8(0);  ROUND8(8);  ROUND8(16); ROUND8(24);
+    ROUND8(32); ROUND8(40); ROUND8(48); ROUND8(56);
+
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+#else
+
+static void Sha256_Block(uint32_t *state, const uint8_t *p)
+{
+    uint32_t w[16];
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for (int i = 0; i < 64; i++)
+    {
+        uint32_t t1, t2;
+
+        if (i < 16)
+            w[i] = LOAD_BE32(p + i * 4);
+        else
+            w[i & 15] += SIG1(w[(i - 2) & 15]) + w[(i - 7) & 15] + SIG0(w[(i - 15) & 15]);
+
+        t1 = h + EP1(e) + CH(e, f, g) + sha256_k[i] + w[i & 15];
+        t2 = EP0(a) + MAJ(a, b, c);
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+}
+
+#endif /* SHA256_UNROLL */
+
+void Sha256_Init(Sha256_Ctx_t *ctx)
+{
+    ctx->state[0] = 0x6a09e667; ctx->state[1] = 0xbb67ae85;
+    ctx->state[2] = 0x3c6ef372; ctx->state[3] = 0xa54ff53a;
+    ctx->state[4] = 0x510e527f; ctx->state[5] = 0x9b05688c;
+    ctx->state[6] = 0x1f83d9ab; ctx->state[7] = 0x5be0cd19;
+    ctx->total = 0;
+}
+
+void Sha256_Update(Sha256_Ctx_t *ctx, const void *data, uint32_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    uint32_t fill = ctx->total & (SHA256_BLOCK_LEN - 1);
+
+    ctx->total += len;
+
+    if (fill)
+    {
+        uint32_t n = SHA256_BLOCK_LEN - fill;
+        if (n > len) n = len;
+        memcpy(ctx->buf + fill, p, n);
+        p += n;
+        len -= n;
+        if (fill + n < SHA256_BLOCK_LEN) return;
+        Sha256_Block(ctx->state, ctx->buf);
+    }
+    while (len >= SHA256_BLOCK_LEN)
+    {
+        Sha256_Block(ctx->state, p);
+        p += SHA256_BLOCK_LEN;
+        len -= SHA256_BLOCK_LEN;
+    }
+    if (len) memcpy(ctx->buf, p, len);
+}
+
+void Sha256_Final(Sha256_Ctx_t *ctx, uint8_t *digest)
+{
+    uint32_t fill = ctx->total & (SHA256_BLOCK_LEN - 1);
+    uint32_t bits_hi = ctx->total >> 29, bits_lo = ctx->total << 3;
+
+    ctx->buf[fill++] = 0x80;
+    if (fill > SHA256_BLOCK_LEN - 8)
+    {
+        memset(ctx->buf + fill, 0, SHA256_BLOCK_LEN - fill);
+        Sha256_Block(ctx->state, ctx->buf);
+        fill = 0;
+    }
+    memset(ctx->buf + fill, 0, SHA256_BLOCK_LEN - 8 - fill);
+    for (int i = 0; i < 4; i++)
+    {
+        ctx->buf[56 + i] = (uint8_t)(bits_hi >> (24 - i * 8));
+        ctx->buf[60 + i] = (uint8_t)(bits_lo >> (24 - i * 8));
+    }
+    Sha256_Block(ctx->state, ctx->buf);
+
+    for (int i = 0; i < 8; i++)
+    {
+        digest[i * 4]     = (uint8_t)(ctx->state[i] >> 24);
+        digest[i * 4 + 1] = (uint8_t)(ctx->state[i] >> 16);
+        digest[i * 4 + 2] = (uint8_t)(ctx->state[i] >> 8);
+        digest[i * 4 + 3] = (uint8_t)ctx->state[i];
+    }
+}
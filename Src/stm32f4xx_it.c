@@ -36,15 +36,91 @@
 #include "stm32f4xx_it.h"
 
 /* USER CODE BEGIN 0 */
+#include "fault.h"
+#include "servo.h"
 
+/* Fault_Entry (below) picks MSP or PSP from EXC_RETURN bit 2 and hands the
+   stacked frame to Fault_Capture: R0 = frame, R1 = Fault_Type_t, R2 = EXC_RETURN. */
+void Fault_Entry(void);
 /* USER CODE END 0 */
 
 /* External variables --------------------------------------------------------*/
+extern DMA_HandleTypeDef hdma_adc3;
+extern TIM_HandleTypeDef htim12;
+extern RNG_HandleTypeDef hrng;
 
 /******************************************************************************/
 /*            Cortex-M4 Processor Interruption and Exception Handlers         */ 
 /******************************************************************************/
 
+/**
+* @brief Hard fault, memory management, bus and usage fault handlers.
+* Written in assembly so that no C prologue touches a possibly broken stack.
+*/
+#if defined(__CC_ARM)
+__asm void Fault_Entry(void)
+{
+  IMPORT  Fault_Capture
+  MOV     R2, LR
+  TST     LR, #4
+  ITE     EQ
+  MRSEQ   R0, MSP
+  MRSNE   R0, PSP
+  B       Fault_Capture
+}
+
+__asm void HardFault_Handler(void)
+{
+  MOVS    R1, #1            ; FAULT_HARD
+  B       __cpp(Fault_Entry)
+}
+
+__asm void MemManage_Handler(void)
+{
+  MOVS    R1, #2            ; FAULT_MEMMANAGE
+  B       __cpp(Fault_Entry)
+}
+
+__asm void BusFault_Handler(void)
+{
+  MOVS    R1, #3            ; FAULT_BUS
+  B       __cpp(Fault_Entry)
+}
+
+__asm void UsageFault_Handler(void)
+{
+  MOVS    R1, #4            ; FAULT_USAGE
+  B       __cpp(Fault_Entry)
+}
+#else
+__attribute__((naked)) void Fault_Entry(void)
+{
+  __asm volatile ("mov   r2, lr  \n"
+                  "tst   lr, #4  \n"
+                  "ite   eq      \n"
+                  "mrseq r0, msp \n"
+                  "mrsne r0, psp \n"
+                  "b     Fault_Capture");
+}
+
+#define FAULT_HANDLER(name, type)   __attribute__((naked)) void name(void) \
+                                    { __asm volatile ("movs r1, #" #type "\n b Fault_Entry"); }
+FAULT_HANDLER(HardFault_Handler, 1)
+FAULT_HANDLER(MemManage_Handler, 2)
+FAULT_HANDLER(BusFault_Handler, 3)
+FAULT_HANDLER(UsageFault_Handler, 4)
+#endif
+
+/**
+* @brief This function handles Pendable request for system service.
+*/
+void PendSV_Handler(void)
+{
+  /* USER CODE BEGIN PendSV_IRQn 0 */
+  Servo_Replan_ISR();   // תķ滮, ȼ
+  /* USER CODE END PendSV_IRQn 0 */
+}
+
 /**
 * @brief This function handles System tick timer.
 */
@@ -81,6 +157,48 @@ void EXTI15_10_IRQHandler(void)
   /* USER CODE END EXTI15_10_IRQn 1 */
 }
 
+/**
+* @brief This function handles TIM8 break interrupt and TIM12 global interrupt.
+*/
+void TIM8_BRK_TIM12_IRQHandler(void)
+{
+  /* USER CODE BEGIN TIM8_BRK_TIM12_IRQn 0 */
+
+  /* USER CODE END TIM8_BRK_TIM12_IRQn 0 */
+  HAL_TIM_IRQHandler(&htim12);
+  /* USER CODE BEGIN TIM8_BRK_TIM12_IRQn 1 */
+
+  /* USER CODE END TIM8_BRK_TIM12_IRQn 1 */
+}
+
+/**
+* @brief This function handles DMA2 stream0 global interrupt.
+*/
+void DMA2_Stream0_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA2_Stream0_IRQn 0 */
+
+  /* USER CODE END DMA2_Stream0_IRQn 0 */
+  HAL_DMA_IRQHandler(&hdma_adc3);
+  /* USER CODE BEGIN DMA2_Stream0_IRQn 1 */
+
+  /* USER CODE END DMA2_Stream0_IRQn 1 */
+}
+
+/**
+* @brief This function handles HASH and RNG global interrupts.
+*/
+void HASH_RNG_IRQHandler(void)
+{
+  /* USER CODE BEGIN HASH_RNG_IRQn 0 */
+
+  /* USER CODE END HASH_RNG_IRQn 0 */
+  HAL_RNG_IRQHandler(&hrng);
+  /* USER CODE BEGIN HASH_RNG_IRQn 1 */
+
+  /* USER CODE END HASH_RNG_IRQn 1 */
+}
+
 /* USER CODE BEGIN 1 */
 
 /* USER CODE END 1 */
@@ -0,0 +1,147 @@
+#include "supervisor.h"
+#include "fault.h"
+#include "persist.h"
+#include "string.h"
+#if SUPERVISOR_WWDG_ENABLE
+#include "wwdg.h"
+#endif
+
+/************************************************************************
+* Źල
+*
+* ԭѭÿֿͷι IWDG, ֻҪѭתͲḴλ: ĳж
+* ͣ (/ADC ɨ), ѭżתһ, .
+*
+* ÿԼ Supervisor_Beat µǰ tick, ѭ
+* Supervisor_Check ϴʱ, ȫڸڲι IWDG;
+* һʱͲι, ʱ IWDG  (3s) ͸λ, мָ˾.
+* ÿμÿ,  =  - , 븴λ
+* жԶ. һγʱһ (FAULT_TRC_WATCHDOG), λܿ˭.
+* ͳƷڱSRAM (BKPSRAM_WDG_ADDR), , ʱλǰż,
+* ÿ 200ms һ, һ.
+*
+* Flash  (ֵ, ־) ʱ CPU ͣ 1~2s, Լֱι
+* IWDG, ֮ῴʱһ, ǳɸ.
+*
+* WWDG (ѡ):  tick ʱι,  wwdg.h Ĵ. ܷɷִ
+* ι,  tick ι̫, Ḵλ.
+*************************************************************************/
+
+#define SUP_WWDG_REFRESH_TICKS   3000    // 300ms,  262~524ms м
+#define SUP_STATS_MAGIC          0x53474457u   // "WDGS"
+#define SUP_REC                  ((Sup_Rec_t *)BKPSRAM_WDG_ADDR)
+
+typedef struct
+{
+    uint32_t magic;
+    Sup_Stats_t stats;
+} Sup_Rec_t;
+
+typedef char sup_size_check[(sizeof(Sup_Rec_t) <= 0x60) ? 1 : -1];
+
+static const uint32_t sup_deadline[SUP_TASK_NUM] =
+{
+    5000,   // ѭ: Ϣһٶ,  500ms;  ( 1s)  Buzzer_Tone Լ
+    1000,   // : 5  PWM 
+    200,    // ADC: 20ms, Լ 80 ɨ
+};
+
+static __IO uint32_t sup_beat[SUP_TASK_NUM];
+static uint8_t sup_late[SUP_TASK_NUM];
+static Sup_Stats_t * const sup_stats = &SUP_REC->stats;
+#if SUPERVISOR_WWDG_ENABLE
+static uint32_t sup_wwdg_tick = 0;
+#endif
+
+
+/**
+  * @brief SRAM  Persist_Init . ¼Чʱͳ
+  */
+void Supervisor_Init(uint8_t is_hot_start)
+{
+    uint32_t now = HAL_GetTick();
+
+    if (!is_hot_start || SUP_REC->magic != SUP_STATS_MAGIC)
+    {
+        memset(sup_stats, 0, sizeof(Sup_Stats_t));
+        for (int i = 0; i < SUP_TASK_NUM; i++)
+        {
+            sup_stats->task[i].min_slack = (int32_t)sup_deadline[i];
+        }
+        SUP_REC->magic = SUP_STATS_MAGIC;
+    }
+
+    for (int i = 0; i < SUP_TASK_NUM; i++)
+    {
+        sup_beat[i] = now;
+        sup_late[i] = 0;
+        sup_stats->task[i].deadline = sup_deadline[i];
+    }
+
+#if SUPERVISOR_WWDG_ENABLE
+    MX_WWDG_Init();
+    HAL_WWDG_Start(&hwwdg);
+    sup_wwdg_tick = now;
+#endif
+}
+
+void Supervisor_Beat(Sup_Task_t task)
+{
+    if (task < SUP_TASK_NUM) sup_beat[task] = HAL_GetTick();
+}
+
+void Supervisor_Check(void)
+{
+    uint32_t now = HAL_GetTick();
+    uint8_t healthy = 1;
+
+    sup_stats->checks++;
+    for (int i = 0; i < SUP_TASK_NUM; i++)
+    {
+        Sup_Task_Stats_t *ts = &sup_stats->task[i];
+        uint32_t age = now - sup_beat[i];
+
+        if (age > ts->max_age)
+        {
+            ts->max_age = age;
+            ts->min_slack = (int32_t)(ts->deadline - age);
+        }
+
+        if (age > ts->deadline)
+        {
+            healthy = 0;
+            if (!sup_late[i])
+            {
+                sup_late[i] = 1;
+                ts->late++;
+                Fault_Trace(FAULT_TRC_WATCHDOG, (uint16_t)i);
+            }
+        }
+        else
+        {
+            sup_late[i] = 0;
+        }
+    }
+
+    if (!healthy)
+    {
+        sup_stats->held++;
+        return;
+    }
+
+    IWDG->KR = IWDG_KEY_RELOAD;
+
+#if SUPERVISOR_WWDG_ENABLE
+    if (now - sup_wwdg_tick >= SUP_WWDG_REFRESH_TICKS)
+    {
+        HAL_WWDG_Refresh(&hwwdg, WWDG_COUNTER);
+        sup_wwdg_tick = now;
+        sup_stats->wwdg_refresh++;
+    }
+#endif
+}
+
+void Supervisor_GetStats(Sup_Stats_t *st)
+{
+    *st = *sup_stats;
+}
@@ -0,0 +1,115 @@
+#include "totp.h"
+#include "sha1.h"
+
+/************************************************************************
+* TOTP һ (RFC 6238, HMAC-SHA1,  30s)
+*
+* HMAC(K, m) = SHA1((K ^ opad) | SHA1((K ^ ipad) | m)). K ^ ipad  K ^ opad
+* ռһ, ͬһԿÿζһ,  Totp_Key_Init ȸѹһ,
+* ֻѹм״̬. ֮ÿ HOTP ֻʣ:
+*
+*   ڲ: |  8 ֽ | 0x80 | 0 ... |  576 λ |
+*   : | ڲժҪ 20 ֽ | 0x80 | 0 ... |  672 λ |
+*
+* 鶼ǰֱƴ, ֽڻ. ͨдһ HMAC ѹ 4 ,
+* ֻҪ 2 .
+*
+* Totp_Match ÿÿͶ (-1, , +1) , ոҲ,
+* ϲ, ǰ˳, ʱֻ͸й.
+*
+* ֻ stdint, Ͽֱӱ (Tools/totp_test.c  RFC Ĳ˶).
+*************************************************************************/
+
+static const uint32_t totp_pow10[9] =
+{
+    1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000
+};
+
+// x == 0 ʱȫ1, ȫ0 (ͬ cred_match.c)
+static uint32_t Totp_Mask_Zero(uint32_t x)
+{
+    return ((x | (0u - x)) >> 31) - 1u;
+}
+
+void Totp_Key_Init(Totp_Key_t *k, const uint8_t *secret, uint32_t len, uint8_t digits)
+{
+    uint32_t w[16];
+
+    if (len > TOTP_KEY_MAX) len = TOTP_KEY_MAX;
+    if (digits > 8) digits = 8;
+
+    for (int i = 0; i < 16; i++) w[i] = 0;
+    for (uint32_t i = 0; i < len; i++)
+    {
+        w[i >> 2] |= (uint32_t)secret[i] << (24 - (i & 3) * 8);
+    }
+
+    for (int i = 0; i < 16; i++) w[i] ^= 0x36363636u;
+    Sha1_Init(k->inner);
+    Sha1_Block(k->inner, w);
+
+    for (int i = 0; i < 16; i++) w[i] ^= 0x36363636u ^ 0x5C5C5C5Cu;
+    Sha1_Init(k->outer);
+    Sha1_Block(k->outer, w);
+
+    for (int i = 0; i < 16; i++) w[i] = 0;   // ջϱԿ
+    k->digits = digits;
+}
+
+uint32_t Totp_Hotp(const Totp_Key_t *k, uint32_t counter)
+{
+    uint32_t w[16], s[5];
+    uint32_t off, bin;
+
+    for (int i = 0; i < 5; i++) s[i] = k->inner[i];
+    w[0] = 0;
+    w[1] = counter;
+    w[2] = 0x80000000u;
+    for (int i = 3; i < 15; i++) w[i] = 0;
+    w[15] = (64 + 8) * 8;
+    Sha1_Block(s, w);
+
+    for (int i = 0; i < 5; i++) w[i] = s[i];
+    w[5] = 0x80000000u;
+    for (int i = 6; i < 15; i++) w[i] = 0;
+    w[15] = (64 + 20) * 8;
+    for (int i = 0; i < 5; i++) s[i] = k->outer[i];
+    Sha1_Block(s, w);
+
+    // ̬ȡ: һֽڵ 4 λƫ, ȡ 31 λ
+    off = s[4] & 0x0F;
+    bin = (s[off >> 2] << ((off & 3) * 8));
+    if (off & 3) bin |= s[(off >> 2) + 1] >> (32 - (off & 3) * 8);
+    bin &= 0x7FFFFFFFu;
+
+    return bin % totp_pow10[k->digits];
+}
+
+uint32_t Totp_Input(const uint8_t *digits)
+{
+    uint32_t v = 0;
+
+    for (int i = 0; i < 8; i++) v = v * 10 + digits[i];
+    return v;
+}
+
+int32_t Totp_Match(const Totp_Key_t *keys, uint32_t n, uint32_t step, uint32_t code, int8_t *drift)
+{
+    uint32_t found = 0, index = 0, which = 0;
+
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint32_t on = ~Totp_Mask_Zero(keys[i].digits);
+
+        for (int32_t d = -TOTP_WINDOW; d <= TOTP_WINDOW; d++)
+        {
+            uint32_t hit = Totp_Mask_Zero(Totp_Hotp(&keys[i], step + d) ^ code) & on & ~found;
+
+            index |= hit & i;
+            which |= hit & (uint32_t)(d + TOTP_WINDOW);
+            found |= hit;
+        }
+    }
+    *drift = (int8_t)((int32_t)which - TOTP_WINDOW);
+    return (int32_t)(index | ~found);
+}
@@ -0,0 +1,199 @@
+#include "visitor.h"
+#include "kv_store.h"
+#include "persist.h"
+#include "dwt.h"
+#include "string.h"
+#include "stdio.h"
+
+/************************************************************************
+* ÿһ (TOTP)
+*
+* ʱÿͲٸ: ÿÿһ, һ 20 ֽԿ (ֻ֤
+* ɨ뵼ͬһԿ), ÿֻϵǰ 6~8 λ,  8 λǰ油 0,
+* ճӺ 8 λ.
+*
+* ÿռֵ: Կǰ 16 ֽ,  Visitor_Meta_t (Կ 4 ֽ
+* ͱ, λ, ʱι, ʱ, ʹô). дԿ, дϢ, 
+* ʱڲ.  HMAC м״̬ (totp.c),
+* RAM ֻ, Կ.
+*
+* ʱ: RTC Ǳʱ,  VISITOR_TZ_OFFSET_S  UTC ٳ 30s ò.
+* ʱûʱÿһɲͨ. ǰһ (TOTP_WINDOW).
+*
+* ط: źõĲżǽSRAM (PersistData.visitor), ͬһ
+* СڵĲ, һڴֻһ. ʱλ;
+* ϵ, øùʣµһֶһ.
+*
+* Уʱ: ÿ 3  HMAC, ÿ 2  SHA-1, 8  48 . ʱֻ
+* VISITOR_MAX й, ʵ verify_cycles  VISITOR_BENCH_ENABLE.
+*************************************************************************/
+
+static Totp_Key_t visitor_key[VISITOR_MAX];
+static Visitor_Meta_t visitor_meta[VISITOR_MAX];
+static Visitor_Stats_t visitor_stats;
+static uint32_t visitor_match_step;     // һͨĲ, Visitor_Used 
+
+typedef char visitor_persist_check[(sizeof(PersistData.visitor.last_step) / 4 >= VISITOR_MAX) ? 1 : -1];
+
+
+static uint8_t Visitor_Load(uint16_t idx)
+{
+    uint8_t secret[VISITOR_SECRET_LEN];
+    Visitor_Meta_t m;
+    uint8_t ok = 0;
+
+    if (KV_Get(KV_KEY_VISITOR_BASE + idx * 2, secret, 16) == 16 &&
+        KV_Get(KV_KEY_VISITOR_BASE + idx * 2 + 1, &m, sizeof(m)) == sizeof(m) &&
+        m.digits >= 6 && m.digits <= 8)
+    {
+        memcpy(secret + 16, m.secret_tail, 4);
+        memset(m.secret_tail, 0, sizeof(m.secret_tail));
+        Totp_Key_Init(&visitor_key[idx], secret, VISITOR_SECRET_LEN, m.digits);
+        visitor_meta[idx] = m;
+        ok = 1;
+    }
+    else
+    {
+        memset(&visitor_key[idx], 0, sizeof(Totp_Key_t));   // digits = 0: ո
+        memset(&visitor_meta[idx], 0, sizeof(Visitor_Meta_t));
+    }
+    memset(secret, 0, sizeof(secret));
+    return ok;
+}
+
+void Visitor_Init(void)
+{
+    memset(&visitor_stats, 0, sizeof(visitor_stats));
+
+    for (int i = 0; i < VISITOR_MAX; i++)
+    {
+        if (Visitor_Load(i)) visitor_stats.count++;
+    }
+}
+
+int16_t Visitor_Verify(const uint8_t *digits, uint32_t now)
+{
+    uint32_t t0 = DWT_CYCCNT_GET();
+    uint32_t step;
+    int8_t drift;
+    int32_t idx;
+
+    if (now == 0) return -1;
+
+    step = (now - VISITOR_TZ_OFFSET_S) / TOTP_STEP_S;
+    idx = Totp_Match(visitor_key, VISITOR_MAX, step, Totp_Input(digits), &drift);
+
+    visitor_stats.verify_cycles = DWT_CYCCNT_GET() - t0;
+    if (visitor_stats.verify_cycles > visitor_stats.verify_max_cycles)
+        visitor_stats.verify_max_cycles = visitor_stats.verify_cycles;
+
+    if (idx < 0) return -1;
+
+    // ںͷطŷƥ֮: ֻӰѾԵ, й¶ĸ
+    if (visitor_meta[idx].expiry && now >= visitor_meta[idx].expiry) return -1;
+    if ((int32_t)(step + drift - PersistData.visitor.last_step[idx]) <= 0)
+    {
+        visitor_stats.replays++;
+        return -1;
+    }
+    visitor_match_step = step + drift;
+    return (int16_t)idx;
+}
+
+uint8_t Visitor_Get(uint16_t idx, Visitor_Meta_t *m)
+{
+    if (idx >= VISITOR_MAX || visitor_key[idx].digits == 0) return 0;
+
+    *m = visitor_meta[idx];
+    return 1;
+}
+
+uint8_t Visitor_Set(uint16_t idx, const uint8_t *secret, const Visitor_Meta_t *m)
+{
+    Visitor_Meta_t rec = *m;
+    uint8_t was;
+
+    if (idx >= VISITOR_MAX || m->digits < 6 || m->digits > 8) return 0;
+
+    memcpy(rec.secret_tail, secret + 16, 4);
+    if (!KV_Set(KV_KEY_VISITOR_BASE + idx * 2, secret, 16) ||
+        !KV_Set(KV_KEY_VISITOR_BASE + idx * 2 + 1, &rec, sizeof(rec)))
+    {
+        memset(&rec, 0, sizeof(rec));
+        return 0;
+    }
+    memset(&rec, 0, sizeof(rec));
+
+    was = (visitor_key[idx].digits != 0);
+    Visitor_Load(idx);
+    if (!was) visitor_stats.count++;
+
+    // Կͷ, ɵĲ
+    PersistData.visitor.last_step[idx] = 0;
+    Persist_MarkDirty(PERSIST_REC_VISITOR);
+    return 1;
+}
+
+uint8_t Visitor_Delete(uint16_t idx)
+{
+    if (idx >= VISITOR_MAX) return 0;
+    if (!KV_Delete(KV_KEY_VISITOR_BASE + idx * 2 + 1) ||
+        !KV_Delete(KV_KEY_VISITOR_BASE + idx * 2)) return 0;
+
+    if (visitor_key[idx].digits) visitor_stats.count--;
+    memset(&visitor_key[idx], 0, sizeof(Totp_Key_t));
+    memset(&visitor_meta[idx], 0, sizeof(Visitor_Meta_t));
+    return 1;
+}
+
+void Visitor_Used(uint16_t idx)
+{
+    Visitor_Meta_t rec;
+
+    if (idx >= VISITOR_MAX) return;
+
+    // 濪ŵ״̬лһύSRAM
+    PersistData.visitor.last_step[idx] = visitor_match_step;
+    Persist_MarkDirty(PERSIST_REC_VISITOR);
+
+    // Կ 4 ֽͬһ¼, ֻĴд
+    visitor_meta[idx].uses++;
+    if (KV_Get(KV_KEY_VISITOR_BASE + idx * 2 + 1, &rec, sizeof(rec)) == sizeof(rec))
+    {
+        rec.uses = visitor_meta[idx].uses;
+        KV_Set(KV_KEY_VISITOR_BASE + idx * 2 + 1, &rec, sizeof(rec));
+    }
+    memset(&rec, 0, sizeof(rec));
+}
+
+void Visitor_GetStats(Visitor_Stats_t *st)
+{
+    *st = visitor_stats;
+}
+
+/**
+  * @brief ˶ RFC 6238 ¼ B ĵһ (T=59s -> 94287082),
+  * ٲ 1 ~ VISITOR_MAX ÿʱһ Totp_Match 
+  */
+void Visitor_Bench(void)
+{
+#if VISITOR_BENCH_ENABLE
+    static Totp_Key_t bench_key[VISITOR_MAX];
+    static const uint8_t rfc_secret[20] = "12345678901234567890";
+    int8_t drift;
+
+    Totp_Key_Init(&bench_key[0], rfc_secret, sizeof(rfc_secret), 8);
+    printf("\r\n [TOTP] RFC 6238 vector: %s",
+           Totp_Hotp(&bench_key[0], 59 / TOTP_STEP_S) == 94287082u ? "ok" : "FAILED");
+
+    for (int i = 1; i < VISITOR_MAX; i++) bench_key[i] = bench_key[0];
+    for (uint32_t n = 1; n <= VISITOR_MAX; n *= 2)
+    {
+        uint32_t t0 = DWT_CYCCNT_GET();
+        volatile int32_t idx = Totp_Match(bench_key, n, 1000, 12345678, &drift);
+        uint32_t cycles = DWT_CYCCNT_GET() - t0;
+        (void)idx;
+        printf("\r\n [TOTP] bench %u visitors: %u cycles (%u us)", n, cycles, DWT_Cycle_To_Us(cycles));
+    }
+#endif
+}
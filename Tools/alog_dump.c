@@ -0,0 +1,222 @@
+/************************************************************************
+* 访问日志导出/解码 (Linux 主机端)
+*
+* 编译:  gcc -O2 -I../Inc -o alog_dump alog_dump.c ../Src/crc32_sw.c
+*
+* 用法:  alog_dump /dev/ttyUSB0 [-o raw.bin]   从板子导出并解码, 可另存原始流
+*        alog_dump -f raw.bin                   解码之前保存的原始流
+*
+* 流程: 115200 发 ALOG_DUMP_CMD, 收到 "[Log] Dump ..." 提示行后切到
+* ALOG_DUMP_BAUD, 读帧头和 count 条 16 字节记录 (格式见 Inc/access_log.h).
+* 每条记录用 Crc32_Sw 校验, 和板子上的硬件 CRC 结果相同. 只支持小端主机.
+*************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/select.h>
+#include <time.h>
+
+#include "access_log.h"
+#include "crc32_sw.h"
+
+#define TIMEOUT_MS   3000
+
+static const char *event_name(uint8_t e)
+{
+    switch (e)
+    {
+        case LOG_EVT_POWER_ON: return "POWER_ON";
+        case LOG_EVT_ARRIVE:   return "ARRIVE";
+        case LOG_EVT_ACCESS:   return "ACCESS";
+        case LOG_EVT_CLOSE:    return "CLOSE";
+        case LOG_EVT_OBSTRUCT: return "OBSTRUCT";
+        default:               return "?";
+    }
+}
+
+static const char *outcome_name(uint8_t o)
+{
+    static const char *names[] = { "-", "GRANTED", "DENIED", "DEPARTED", "TIMEOUT", "REVERSED", "STOPPED", "SCHEDULE" };
+    return (o < sizeof(names) / sizeof(names[0])) ? names[o] : "?";
+}
+
+static const char *state_name(uint8_t s)
+{
+    static const char *names[] = { "IDLE", "INPUT", "VERIFY", "OPEN", "ERROR" };
+    return (s < sizeof(names) / sizeof(names[0])) ? names[s] : "?";
+}
+
+// 版本2起 time 是 RTC 本地时间的秒数 (不带时区, 用 gmtime 还原); 版本1是系统节拍
+static const char *time_str(const AccessLog_Dump_Head_t *head, uint32_t t)
+{
+    static char buf[24];
+    time_t tt = (time_t)t;
+    struct tm tm;
+
+    if (head->version < 2)
+        snprintf(buf, sizeof(buf), "tick %u", t);
+    else if (t == 0)
+        snprintf(buf, sizeof(buf), "(clock not set)");
+    else
+        strftime(buf, sizeof(buf), "%Y-%m-%d %H:%M:%S", gmtime_r(&tt, &tm));
+    return buf;
+}
+
+static int set_baud(int fd, speed_t baud)
+{
+    struct termios tio;
+
+    if (tcgetattr(fd, &tio) < 0) return -1;
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 0;
+    cfsetispeed(&tio, baud);
+    cfsetospeed(&tio, baud);
+    return tcsetattr(fd, TCSANOW, &tio);
+}
+
+// 读满 len 字节, 超时返回已读字节数
+static size_t read_full(int fd, void *buf, size_t len)
+{
+    size_t got = 0;
+
+    while (got < len)
+    {
+        fd_set rd;
+        struct timeval tv = { TIMEOUT_MS / 1000, (TIMEOUT_MS % 1000) * 1000 };
+        ssize_t n;
+
+        FD_ZERO(&rd);
+        FD_SET(fd, &rd);
+        if (select(fd + 1, &rd, NULL, NULL, &tv) <= 0) break;
+        n = read(fd, (uint8_t *)buf + got, len - got);
+        if (n <= 0) break;
+        got += (size_t)n;
+    }
+    return got;
+}
+
+// 等提示行 "[Log] Dump ...\r\n", 之前的普通打印丢掉
+static int wait_banner(int fd)
+{
+    char line[256];
+    size_t pos = 0;
+    char c;
+
+    while (read_full(fd, &c, 1) == 1)
+    {
+        if (c == '\n')
+        {
+            line[pos] = '\0';
+            if (strstr(line, "[Log] Dump"))
+            {
+                fprintf(stderr, "%s\n", line);
+                return 0;
+            }
+            pos = 0;
+        }
+        else if (pos < sizeof(line) - 1)
+        {
+            line[pos++] = c;
+        }
+    }
+    return -1;
+}
+
+static int decode(const AccessLog_Dump_Head_t *head, const AccessLog_Record_t *rec)
+{
+    uint32_t bad = 0, gaps = 0;
+
+    printf("%8s  %-19s  %-8s  %4s  %-8s  %s\n", "seq", "time", "event", "keys", "outcome", "state");
+    for (uint32_t i = 0; i < head->count; i++)
+    {
+        const AccessLog_Record_t *r = &rec[i];
+
+        if (r->crc != Crc32_Sw((const uint32_t *)r, 3))
+        {
+            bad++;
+            continue;
+        }
+        if (i > 0 && r->seq != rec[i - 1].seq + 1) gaps++;
+
+        printf("%8u  %-19s  %-8s  %4u  %-8s  %s\n", r->seq, time_str(head, r->time), event_name(r->event),
+               r->keys, outcome_name(r->outcome), state_name(r->state));
+    }
+    fprintf(stderr, "%u records, %u bad crc, %u seq gaps\n", head->count, bad, gaps);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    AccessLog_Dump_Head_t head;
+    AccessLog_Record_t *rec;
+    const char *out = NULL;
+    size_t size;
+    int fd;
+
+    if (argc >= 3 && strcmp(argv[1], "-f") == 0)
+    {
+        fd = open(argv[2], O_RDONLY);
+        if (fd < 0) { perror(argv[2]); return 1; }
+    }
+    else if (argc >= 2)
+    {
+        char cmd = ALOG_DUMP_CMD;
+
+        if (argc >= 4 && strcmp(argv[2], "-o") == 0) out = argv[3];
+        fd = open(argv[1], O_RDWR | O_NOCTTY);
+        if (fd < 0) { perror(argv[1]); return 1; }
+        set_baud(fd, B115200);
+        tcflush(fd, TCIOFLUSH);
+        if (write(fd, &cmd, 1) != 1 || wait_banner(fd) < 0)
+        {
+            fprintf(stderr, "no dump banner\n");
+            return 1;
+        }
+        set_baud(fd, B500000);   // ALOG_DUMP_BAUD
+    }
+    else
+    {
+        fprintf(stderr, "usage: %s <tty> [-o raw.bin] | -f raw.bin\n", argv[0]);
+        return 2;
+    }
+
+    if (read_full(fd, &head, sizeof(head)) != sizeof(head) ||
+        head.magic != ALOG_DUMP_MAGIC ||
+        head.crc != Crc32_Sw((const uint32_t *)&head, 3) ||
+        head.rec_size != sizeof(AccessLog_Record_t))
+    {
+        fprintf(stderr, "bad dump header\n");
+        return 1;
+    }
+
+    size = (size_t)head.count * sizeof(AccessLog_Record_t);
+    rec = malloc(size ? size : 1);
+    if (rec == NULL) return 1;
+    if (read_full(fd, rec, size) != size)
+    {
+        fprintf(stderr, "short read, expected %u records\n", head.count);
+        return 1;
+    }
+    close(fd);
+
+    if (out)
+    {
+        FILE *f = fopen(out, "wb");
+        if (f)
+        {
+            fwrite(&head, sizeof(head), 1, f);
+            fwrite(rec, 1, size, f);
+            fclose(f);
+        }
+    }
+
+    decode(&head, rec);
+    free(rec);
+    return 0;
+}
@@ -0,0 +1,91 @@
+/************************************************************************
+* 密码比较的时序侧信道测试 (Linux 主机端)
+*
+* 编译:  gcc -O2 -I../Inc -o ct_bench ct_bench.c ../Src/ct_bench.c ../Src/ct_compare.c -lm
+*
+* 用法:  ct_bench [每个函数的样本数, 默认 1000000] [-v]
+*
+* 测 Ct_Compare_Xor / Ct_Compare_Sub (门禁比较 32 字节摘要用的两种算法),
+* 按前缀匹配长度分组报告周期数分布和 Welch t. 任一个 |t| 超过
+* CT_T_THRESHOLD 退出码为 1, 可以直接挂在构建脚本里: 谁改出了提前退出,
+* 这里就过不去. 反例 Ct_Compare_Early 必须被测出来, 测不出来也返回 1
+* (说明计时或样本数不够, 结论不可信).
+*
+* 计时: x86 上用 rdtsc, 别的平台用 clock_gettime (纳秒). 主机和 M4 的
+* 微结构不一样, 这里过了不等于板子上也过, 板子上见 PWD_CT_BENCH_ENABLE.
+*************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "ct_bench.h"
+#include "ct_compare.h"
+
+static uint32_t host_clock(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_lfence();   // 不让前后的指令乱序进计时区
+    uint32_t t = (uint32_t)__rdtsc();
+    _mm_lfence();
+    return t;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000000ull + ts.tv_nsec);
+#endif
+}
+
+static Ct_Result_t res;
+
+static double report(const char *name, Ct_Fn_t fn, uint32_t samples, int verbose)
+{
+    Ct_Bench_Run(&res, fn, CT_LEN_MAX, samples, host_clock, 0x12345678u, NULL);
+
+    printf("%-6s |t| max %7.2f at prefix %2u, cutoff %u, dropped %u\n",
+           name, res.t_max, res.t_len, res.cutoff, res.dropped);
+    if (verbose)
+    {
+        printf("  prefix        n      mean   min   max\n");
+        for (uint32_t l = 0; l <= res.len; l++)
+        {
+            const Ct_Acc_t *b = &res.bucket[l];
+            printf("  %6u %8u %9.2f %5u %5u\n", l, b->n, b->mean, b->min, b->max);
+        }
+    }
+    return res.t_max;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t samples = 1000000;
+    int verbose = 0, fail = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-v") == 0) verbose = 1;
+        else samples = (uint32_t)strtoul(argv[i], NULL, 0);
+    }
+
+    if (report("xor", Ct_Compare_Xor, samples, verbose) > CT_T_THRESHOLD)
+    {
+        printf("FAIL: Ct_Compare_Xor timing depends on the matching prefix\n");
+        fail = 1;
+    }
+    if (report("sub", Ct_Compare_Sub, samples, verbose) > CT_T_THRESHOLD)
+    {
+        printf("FAIL: Ct_Compare_Sub timing depends on the matching prefix\n");
+        fail = 1;
+    }
+    if (report("early", Ct_Compare_Early, samples, verbose) <= CT_T_THRESHOLD)
+    {
+        printf("FAIL: early-exit reference not detected, result not trustworthy\n");
+        fail = 1;
+    }
+    printf("%s\n", fail ? "FAILED" : "ok");
+    return fail;
+}
@@ -0,0 +1,301 @@
+/************************************************************************
+* 红外解码 -> 按键 -> 门禁状态机 的模糊测试 (Linux 主机端)
+*
+* libFuzzer:  clang -g -O1 -fsanitize=fuzzer,address,undefined -DIR_FUZZ_LIBFUZZER -I../Inc \
+*                 -o ir_fuzz ir_fuzz.c ../Src/ir_decode.c ../Src/door_fsm.c
+*             ./ir_fuzz -jobs=$(nproc) -workers=$(nproc) ir_fuzz_corpus/
+* AFL++:      afl-clang-fast -O1 -I../Inc -o ir_fuzz_afl ir_fuzz.c ../Src/ir_decode.c ../Src/door_fsm.c
+*             afl-fuzz -i ir_fuzz_corpus -o afl_out -M m0 -- ./ir_fuzz_afl @@
+*             afl-fuzz -i ir_fuzz_corpus -o afl_out -S s1 -- ./ir_fuzz_afl @@   (每个核一个 -S)
+* 回归:       gcc -O2 -I../Inc -o ir_fuzz ir_fuzz.c ../Src/ir_decode.c ../Src/door_fsm.c
+*             ./ir_fuzz ir_fuzz_corpus      目录里每个文件跑一遍 (也可以给文件), 违例时 abort
+*             ./ir_fuzz -g ir_fuzz_corpus     重新生成种子
+*
+* 输入和 .irc 抓包的边沿数据同一格式 (Inc/ir_capture.h): 小端 16 位,
+* bit0 边沿后的电平, bit15..1 离上一个边沿的 us. 现场抓包去掉 20 字节帧头
+* 就能当种子. dt 为 0 的边沿 (真实波形里没有) 当控制事件: 电平 1 车刚离开,
+* 电平 0 闸下有车/没车切换.
+*
+* 流程和板子上一样: IR_Decode_Edge -> IR_Decode_Split + 出厂键位表
+* -> IR_Hold_xxx -> Door_Step, 密码固定为 fuzz_pwd. 板子上主循环每个 tick
+* 都转, 这里只在边沿时刻转一轮; 状态机里的计时都是 >=, 只会晚到不会漏.
+* 违例 abort, 让 fuzzer 记下用例:
+*   1. 解码器边沿计数不超过 IR_DEC_EDGES, input_index 不超过 DOOR_PWD_LEN,
+*      状态在 SystemState_t 范围里
+*   2. 进 OPEN 只能是 VERIFY 校验通过, 当时缓存里正好是 8 位正确密码
+*   3. 边沿喂完后没车也不再按键, 按 100ms 一步空转 DRAIN_TICKS 内回到 IDLE
+* 没模拟的: 防暴力锁定 (lockout.c), 学习模式, 按键队列满丢键.
+*************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+
+#include "ir_capture.h"
+#include "ir_decode.h"
+#include "door_fsm.h"
+
+#define DRAIN_STEP      1000          // 100ms
+#define DRAIN_TICKS     (INPUT_TIMEOUT_TICKS + OPEN_HOLD_MAX_TICKS + ERR_HOLD_TICKS)
+#define FILE_MAX        (1 << 20)
+
+#define CHECK(cond) \
+    do { if (!(cond)) { fprintf(stderr, "ir_fuzz: %s (line %d)\n", #cond, __LINE__); abort(); } } while (0)
+
+// 出厂键位: 0~9, DEL 的命令码, 任何遥控都认 (Src/ir_keymap.c)
+static const uint8_t factory_cmd[11] = { 0xB8, 0x08, 0x88, 0x48, 0xC8, 0x28, 0xA8, 0xE8, 0x18, 0x98, 0x78 };
+static const uint8_t fuzz_pwd[DOOR_PWD_LEN] = { 2, 0, 2, 4, 0, 6, 1, 8 };
+
+typedef struct
+{
+    IR_Decoder_t dec;
+    IR_Hold_t    hold;
+    Door_Fsm_t   door;
+    uint64_t     us;
+    uint8_t      vehicle;
+} Sim_t;
+
+static uint8_t factory_key(uint8_t cmd)
+{
+    for (int i = 0; i < 11; i++)
+        if (factory_cmd[i] == cmd) return i == 10 ? DOOR_KEY_DEL : (uint8_t)i;
+    return DOOR_KEY_NONE;
+}
+
+static void sim_step(Sim_t *s, uint8_t key, uint8_t key_long, uint8_t departed)
+{
+    Door_Input_t in;
+    uint8_t prev = s->door.state, granted = 0;
+    uint32_t act;
+
+    in.now = (uint32_t)(s->us / 100);
+    in.key = key;
+    in.key_long = key_long;
+    in.departed = departed;
+    in.vehicle = s->vehicle;
+
+    act = Door_Step(&s->door, &in);
+    if (act & DOOR_ACT_VERIFY)
+    {
+        CHECK(s->door.state == SYS_VERIFY);
+        granted = s->door.input_index == DOOR_PWD_LEN &&
+                  memcmp(s->door.input_buf, fuzz_pwd, DOOR_PWD_LEN) == 0;
+        act |= Door_Verdict(&s->door, granted, in.now);
+    }
+    // 和 main.c 一样, 进 VERIFY 后结果晚 5~20ms 出
+    if ((act & DOOR_ACT_STATE) && s->door.state == SYS_VERIFY)
+        s->door.verify_due += 50 + (uint32_t)(s->us % 151);
+
+    CHECK(s->dec.edges <= IR_DEC_EDGES);
+    CHECK(s->door.input_index <= DOOR_PWD_LEN);
+    CHECK(s->door.state <= SYS_ERROR);
+    if (s->door.state == SYS_OPEN && prev != SYS_OPEN)
+    {
+        CHECK(prev == SYS_VERIFY && granted);
+        CHECK(memcmp(s->door.input_buf, fuzz_pwd, DOOR_PWD_LEN) == 0);
+    }
+}
+
+static void sim_edge(Sim_t *s, uint16_t e)
+{
+    uint32_t dt = IR_CAP_DT(e), raw, tick;
+    uint16_t addr;
+    uint8_t cmd, key;
+
+    if (dt == 0)
+    {
+        if (IR_CAP_LEVEL(e)) sim_step(s, DOOR_KEY_NONE, DOOR_KEY_NONE, 1);
+        else s->vehicle = !s->vehicle;
+        return;
+    }
+
+    s->us += dt;
+    tick = (uint32_t)(s->us / 100);
+    switch (IR_Decode_Edge(&s->dec, IR_CAP_LEVEL(e), dt, &raw))
+    {
+        case IR_DEC_FRAME:
+            IR_Hold_Press(&s->hold, IR_HOLD_NONE, 0, tick);
+            key = IR_Decode_Split(raw, &addr, &cmd) ? factory_key(cmd) : DOOR_KEY_NONE;
+            if (key != DOOR_KEY_NONE) IR_Hold_Press(&s->hold, key, (uint8_t)(raw >> 24), tick);
+            sim_step(s, key, DOOR_KEY_NONE, 0);
+            break;
+        case IR_DEC_REPEAT:
+            if (IR_Hold_Repeat(&s->hold, tick) == IR_HOLD_LONG)
+                sim_step(s, DOOR_KEY_NONE, s->hold.key, 0);
+            else
+                sim_step(s, DOOR_KEY_NONE, DOOR_KEY_NONE, 0);
+            break;
+        default:
+            sim_step(s, DOOR_KEY_NONE, DOOR_KEY_NONE, 0);
+            break;
+    }
+}
+
+static void sim_run(const uint8_t *data, size_t size)
+{
+    Sim_t s;
+
+    memset(&s, 0, sizeof(s));
+    IR_Decode_Reset(&s.dec);
+    IR_Hold_Press(&s.hold, IR_HOLD_NONE, 0, 0);
+    Door_Init(&s.door);
+
+    for (size_t i = 0; i + 1 < size; i += 2)
+        sim_edge(&s, (uint16_t)(data[i] | (data[i + 1] << 8)));
+
+    // 人和车都走了: 不管停在哪个状态, 最后都要回待机
+    s.vehicle = 0;
+    for (uint32_t t = 0; t < DRAIN_TICKS && s.door.state != SYS_IDLE; t += DRAIN_STEP)
+    {
+        s.us += DRAIN_STEP * 100;
+        sim_step(&s, DOOR_KEY_NONE, DOOR_KEY_NONE, 0);
+    }
+    CHECK(s.door.state == SYS_IDLE);
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    sim_run(data, size);
+    return 0;
+}
+
+#ifndef IR_FUZZ_LIBFUZZER
+
+/* 种子: 合成的 NEC 波形 (同 ir_replay -g) 加上控制事件 */
+static uint16_t seed[4096];
+static unsigned seed_n;
+
+static void seed_edge(uint8_t level, uint32_t us)
+{
+    if (seed_n < sizeof(seed) / sizeof(seed[0])) seed[seed_n++] = IR_CAP_ENTRY(us, level);
+}
+
+static void seed_key(uint8_t key, uint32_t gap_us)
+{
+    uint8_t cmd = factory_cmd[key == DOOR_KEY_DEL ? 10 : key];
+    uint32_t code = (0x00u << 24) | (0xFFu << 16) | ((uint32_t)cmd << 8) | (uint8_t)~cmd;
+
+    seed_edge(0, gap_us);
+    seed_edge(1, 9000);
+    seed_edge(0, 4500);
+    for (int b = 31; b >= 0; b--)
+    {
+        seed_edge(1, 560);
+        seed_edge(0, ((code >> b) & 1) ? 1690 : 560);
+    }
+    seed_edge(1, 560);
+}
+
+static void seed_repeat(uint32_t gap_us)
+{
+    seed_edge(0, gap_us);
+    seed_edge(1, 9000);
+    seed_edge(0, 2250);
+    seed_edge(1, 560);
+}
+
+static int seed_save(const char *dir, const char *name)
+{
+    char path[512];
+    FILE *f;
+
+    snprintf(path, sizeof(path), "%s/%s", dir, name);
+    f = fopen(path, "wb");
+    if (!f) { perror(path); return -1; }
+    fwrite(seed, 2, seed_n, f);   // 小端主机
+    fclose(f);
+    printf("%s: %u edges\n", path, seed_n);
+    seed_n = 0;
+    return 0;
+}
+
+static int seed_gen(const char *dir)
+{
+    static const uint8_t wrong[DOOR_PWD_LEN] = { 2, 0, 2, 4, 0, 6, 1, 9 };
+    int err = 0;
+
+    for (int i = 0; i < DOOR_PWD_LEN; i++) seed_key(fuzz_pwd[i], 300000);
+    seed_edge(1, 0);                                   // 车通过
+    err |= seed_save(dir, "open.bin");
+
+    for (int i = 0; i < DOOR_PWD_LEN; i++) seed_key(wrong[i], 300000);
+    err |= seed_save(dir, "wrong.bin");
+
+    // 输三位, 删一位, 按住 DEL 清空, 再输对
+    for (int i = 0; i < 3; i++) seed_key(fuzz_pwd[i], 300000);
+    seed_key(DOOR_KEY_DEL, 300000);
+    seed_key(DOOR_KEY_DEL, 300000);
+    for (int i = 0; i < 24; i++) seed_repeat(i == 0 ? 40000 : IR_CAP_DT_MAX);   // 间隔超过 dt 上限, 按上限算
+    for (int i = 0; i < DOOR_PWD_LEN; i++) seed_key(fuzz_pwd[i], 300000);
+    err |= seed_save(dir, "del.bin");
+
+    // 开门后车停在闸下, 过一会儿离开
+    for (int i = 0; i < DOOR_PWD_LEN; i++) seed_key(fuzz_pwd[i], 300000);
+    seed_edge(0, 0);
+    for (int i = 0; i < 200; i++) seed_edge(1, IR_CAP_DT_MAX);   // 空闲 6.5s, 超过 OPEN_TIMEOUT_TICKS
+    seed_edge(0, 0);
+    seed_edge(1, 0);
+    err |= seed_save(dir, "vehicle.bin");
+
+    // 输到一半不按了
+    for (int i = 0; i < 5; i++) seed_key(fuzz_pwd[i], 300000);
+    err |= seed_save(dir, "partial.bin");
+    return err ? 1 : 0;
+}
+
+static int run_file(const char *path)
+{
+    static uint8_t buf[FILE_MAX];
+    FILE *f = fopen(path, "rb");
+    size_t n;
+
+    if (!f) { perror(path); return -1; }
+    n = fread(buf, 1, sizeof(buf), f);
+    fclose(f);
+    sim_run(buf, n);
+    return 0;
+}
+
+// 参数是目录就跑里面每个文件, 返回跑了几个
+static int run_path(const char *path)
+{
+    char file[512];
+    struct dirent *de;
+    DIR *dir = opendir(path);
+    int n = 0;
+
+    if (!dir) return run_file(path) < 0 ? -1 : 1;
+    while ((de = readdir(dir)) != NULL)
+    {
+        if (de->d_name[0] == '.') continue;
+        snprintf(file, sizeof(file), "%s/%s", path, de->d_name);
+        if (run_file(file) < 0) { n = -1; break; }
+        n++;
+    }
+    closedir(dir);
+    return n;
+}
+
+int main(int argc, char **argv)
+{
+    int files = 0, n;
+
+    if (argc >= 3 && strcmp(argv[1], "-g") == 0)
+        return seed_gen(argv[2]);
+
+    if (argc < 2)
+    {
+        fprintf(stderr, "usage: ir_fuzz file... | -g dir\n");
+        return 1;
+    }
+    for (int i = 1; i < argc; i++)
+    {
+        if ((n = run_path(argv[i])) < 0) return 1;
+        files += n;
+    }
+    printf("%d files ok\n", files);
+    return 0;
+}
+
+#endif /* IR_FUZZ_LIBFUZZER */
@@ -0,0 +1,450 @@
+/************************************************************************
+* 红外原始边沿抓包的导出/回放 (Linux 主机端)
+*
+* 编译:  gcc -O2 -I../Inc -o ir_replay ir_replay.c ../Src/ir_decode.c ../Src/crc32_sw.c
+*
+* 用法:  ir_replay /dev/ttyUSB0 [-o cap.irc]   从板子导出抓包 (先在板子上发 'E' 开始抓)
+*        ir_replay -f cap.irc                   回放一个抓包, 打印解码结果
+*        ir_replay -c ir_corpus [-u]            回归: 目录里每个 x.irc 回放结果和 x.txt 比,
+*                                               -u 重新生成 x.txt
+*        ir_replay -g nec|necx|repeat|noise out.irc   生成合成波形
+*        ir_replay -b [秒数, 默认 2]            回放速度测试
+*
+* 抓包格式见 Inc/ir_capture.h: 帧头 + 每个边沿 16 位 (电平 + 离上一个边沿的 us).
+* .irc 文件就是串口收到的原始流, 帧头和数据都用 Crc32_Sw 校验.
+* 解码直接编译板子上的 Src/ir_decode.c, 主机上的结果和板子上一致.
+* 现场抓到的问题波形放进 ir_corpus/ 再 -u 生成期望输出, 以后改解码
+* 就用 -c 跑一遍, 任何一个文件结果变了退出码为 1. 只支持小端主机.
+*************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <termios.h>
+#include <dirent.h>
+#include <sys/select.h>
+#include <time.h>
+
+#include "ir_capture.h"
+#include "ir_decode.h"
+#include "crc32_sw.h"
+
+#define TIMEOUT_MS    3000
+#define SYNTH_MAX     0xFFFE          // 帧头 count 是 16 位
+#define OUT_MAX       65536
+
+typedef struct
+{
+    IR_Capture_Head_t head;
+    uint16_t edge[SYNTH_MAX + 1];   // 多一个给奇数个时补 0
+} Capture_t;
+
+static Capture_t cap;
+
+static int set_baud(int fd, speed_t baud)
+{
+    struct termios tio;
+
+    if (tcgetattr(fd, &tio) < 0) return -1;
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 0;
+    cfsetispeed(&tio, baud);
+    cfsetospeed(&tio, baud);
+    return tcsetattr(fd, TCSANOW, &tio);
+}
+
+// 读满 len 字节, 超时返回已读字节数
+static size_t read_full(int fd, void *buf, size_t len)
+{
+    size_t got = 0;
+
+    while (got < len)
+    {
+        fd_set rd;
+        struct timeval tv = { TIMEOUT_MS / 1000, (TIMEOUT_MS % 1000) * 1000 };
+        ssize_t n;
+
+        FD_ZERO(&rd);
+        FD_SET(fd, &rd);
+        if (select(fd + 1, &rd, NULL, NULL, &tv) <= 0) break;
+        n = read(fd, (uint8_t *)buf + got, len - got);
+        if (n <= 0) break;
+        got += (size_t)n;
+    }
+    return got;
+}
+
+// 等提示行 "[IR] Capture dump ...\r\n", 之前的普通打印丢掉
+static int wait_banner(int fd)
+{
+    char line[256];
+    size_t pos = 0;
+    char c;
+
+    while (read_full(fd, &c, 1) == 1)
+    {
+        if (c == '\n')
+        {
+            line[pos] = '\0';
+            if (strstr(line, "[IR] Capture dump"))
+            {
+                fprintf(stderr, "%s\n", line);
+                return 0;
+            }
+            pos = 0;
+        }
+        else if (pos < sizeof(line) - 1)
+        {
+            line[pos++] = c;
+        }
+    }
+    return -1;
+}
+
+static void cap_seal(Capture_t *c)
+{
+    uint32_t n = c->head.count;
+
+    if (n & 1) c->edge[n] = 0;
+    c->head.magic = IR_CAP_MAGIC;
+    c->head.version = IR_CAP_VERSION;
+    c->head.data_crc = Crc32_Sw((const uint32_t *)c->edge, (n + 1) / 2);
+    c->head.crc = Crc32_Sw((const uint32_t *)&c->head, 4);
+}
+
+// 从文件或串口读帧头和边沿, 校验不过返回 -1
+static int cap_read(int fd, Capture_t *c)
+{
+    uint32_t n;
+
+    if (read_full(fd, &c->head, sizeof(c->head)) != sizeof(c->head) ||
+        c->head.magic != IR_CAP_MAGIC ||
+        c->head.version != IR_CAP_VERSION ||
+        c->head.crc != Crc32_Sw((const uint32_t *)&c->head, 4))
+    {
+        fprintf(stderr, "bad capture header\n");
+        return -1;
+    }
+    n = c->head.count;
+    if (n > SYNTH_MAX || read_full(fd, c->edge, n * 2u) != n * 2u)
+    {
+        fprintf(stderr, "short read, expected %u edges\n", n);
+        return -1;
+    }
+    if (n & 1) c->edge[n] = 0;
+    if (c->head.data_crc != Crc32_Sw((const uint32_t *)c->edge, (n + 1) / 2))
+    {
+        fprintf(stderr, "bad capture data crc\n");
+        return -1;
+    }
+    return 0;
+}
+
+static int cap_load(const char *path, Capture_t *c)
+{
+    int fd = open(path, O_RDONLY);
+    int ret;
+
+    if (fd < 0)
+    {
+        perror(path);
+        return -1;
+    }
+    ret = cap_read(fd, c);
+    close(fd);
+    return ret;
+}
+
+static int cap_save(const char *path, const Capture_t *c)
+{
+    FILE *f = fopen(path, "wb");
+
+    if (f == NULL)
+    {
+        perror(path);
+        return -1;
+    }
+    fwrite(&c->head, sizeof(c->head), 1, f);
+    fwrite(c->edge, 2, c->head.count, f);
+    fclose(f);
+    return 0;
+}
+
+// 回放: 每个事件一行, 时间是从第一个边沿算起的 us
+static size_t replay(const Capture_t *c, char *out, size_t size)
+{
+    IR_Decoder_t dec;
+    uint64_t t = 0;
+    uint32_t frames = 0, repeats = 0;
+    size_t len = 0;
+
+    IR_Decode_Reset(&dec);
+    for (uint32_t i = 0; i < c->head.count && len < size; i++)
+    {
+        uint16_t e = c->edge[i];
+        uint32_t code;
+
+        if (i > 0) t += IR_CAP_DT(e);
+        switch (IR_Decode_Edge(&dec, IR_CAP_LEVEL(e), IR_CAP_DT(e), &code))
+        {
+            case IR_DEC_FRAME:
+            {
+                uint8_t id = code >> 24, id_not = code >> 16, cmd = code >> 8, cmd_not = code;
+                const char *kind = ((cmd ^ cmd_not) != 0xFF) ? "BAD" : ((id ^ id_not) == 0xFF) ? "NEC" : "NECX";
+
+                len += snprintf(out + len, size - len, "%10llu  FRAME   0x%08X  %-4s addr 0x%02X%02X cmd 0x%02X\n",
+                                (unsigned long long)t, code, kind, id, id_not, cmd);
+                frames++;
+                break;
+            }
+            case IR_DEC_REPEAT:
+                len += snprintf(out + len, size - len, "%10llu  REPEAT\n", (unsigned long long)t);
+                repeats++;
+                break;
+            default:
+                break;
+        }
+    }
+    if (len < size)
+        len += snprintf(out + len, size - len, "# %u edges (%u dropped), %u frames, %u repeats\n",
+                        c->head.count, c->head.dropped, frames, repeats);
+    return len < size ? len : size - 1;
+}
+
+/* 合成波形: NEC 标准时序 + 抖动. 板子上按高位先到拼 code, 这里也按高位先发 */
+static uint32_t synth_rng = 0x2545F491;
+
+static uint32_t synth_rand(void)
+{
+    synth_rng ^= synth_rng << 13;
+    synth_rng ^= synth_rng >> 17;
+    synth_rng ^= synth_rng << 5;
+    return synth_rng;
+}
+
+static void synth_edge(Capture_t *c, uint8_t level, uint32_t us, uint32_t jitter)
+{
+    if (c->head.count >= SYNTH_MAX) return;
+    if (jitter) us = us - jitter + synth_rand() % (2 * jitter + 1);
+    c->edge[c->head.count++] = IR_CAP_ENTRY(us, level);
+}
+
+// 一帧从空闲 gap_us 后的下降沿开始, 到结束位的上升沿
+static void synth_frame(Capture_t *c, uint32_t code, uint32_t gap_us, uint32_t jitter)
+{
+    synth_edge(c, 0, gap_us, 0);
+    synth_edge(c, 1, 9000, jitter * 4);
+    synth_edge(c, 0, 4500, jitter * 2);
+    for (int b = 31; b >= 0; b--)
+    {
+        synth_edge(c, 1, 560, jitter);
+        synth_edge(c, 0, ((code >> b) & 1) ? 1690 : 560, jitter);
+    }
+    synth_edge(c, 1, 560, jitter);
+}
+
+static void synth_repeat(Capture_t *c, uint32_t gap_us, uint32_t jitter)
+{
+    synth_edge(c, 0, gap_us, 0);
+    synth_edge(c, 1, 9000, jitter * 4);
+    synth_edge(c, 0, 2250, jitter * 2);
+    synth_edge(c, 1, 560, jitter);
+}
+
+#define NEC_CODE(a, c)        (((uint32_t)(a) << 24) | ((uint32_t)(uint8_t)~(a) << 16) | ((uint32_t)(c) << 8) | (uint8_t)~(c))
+#define NECX_CODE(a16, c)     (((uint32_t)(a16) << 16) | ((uint32_t)(c) << 8) | (uint8_t)~(c))
+
+static int synth(const char *kind, Capture_t *c)
+{
+    static const uint8_t keys[] = { 0x68, 0x30, 0x18, 0x7A, 0x10, 0x38, 0x5A, 0x42, 0x4A, 0x52, 0x78 };
+
+    memset(&c->head, 0, sizeof(c->head));
+    synth_rng = 0x2545F491;
+
+    if (strcmp(kind, "nec") == 0)
+    {
+        for (unsigned i = 0; i < sizeof(keys); i++)
+            synth_frame(c, NEC_CODE(0x00, keys[i]), 300000, 60);
+    }
+    else if (strcmp(kind, "necx") == 0)
+    {
+        for (unsigned i = 0; i < sizeof(keys); i++)
+            synth_frame(c, NECX_CODE(0x40BE, keys[i]), 300000, 60);
+    }
+    else if (strcmp(kind, "repeat") == 0)
+    {
+        // 按住 1.2s: 一帧 + 每 108ms 一个重复码; 再来一个前面没有帧的重复码
+        synth_frame(c, NEC_CODE(0x00, 0x78), 300000, 60);
+        for (int i = 0; i < 11; i++) synth_repeat(c, i == 0 ? 40000 : 96000, 60);
+        synth_repeat(c, IR_CAP_DT_MAX, 60);
+    }
+    else if (strcmp(kind, "noise") == 0)
+    {
+        // 两帧中间夹着毛刺和截断的帧, 时序抖动大到接近窗口边上
+        synth_frame(c, NEC_CODE(0x00, 0x30), 300000, 150);
+        for (int i = 0; i < 40; i++) synth_edge(c, i & 1, 20 + synth_rand() % 3000, 0);
+        synth_frame(c, NEC_CODE(0x00, 0x18) ^ 0x00000100, 300000, 150);   // 命令码反码不对
+        synth_frame(c, NEC_CODE(0x00, 0x10), 300000, 150);
+        c->head.count -= 20;                                             // 截断, 紧跟的一帧
+        synth_frame(c, NEC_CODE(0x00, 0x18), 50000, 150);                // 引导码会被吃掉
+        synth_frame(c, NECX_CODE(0x1234, 0x7A), 300000, 200);
+    }
+    else
+    {
+        fprintf(stderr, "unknown kind %s\n", kind);
+        return -1;
+    }
+    cap_seal(c);
+    return 0;
+}
+
+// 回归: 目录里的每个 .irc 和同名 .txt 比较
+static int corpus(const char *dir, int update)
+{
+    static char out[OUT_MAX], want[OUT_MAX];
+    char path[1024];
+    struct dirent *de;
+    DIR *d = opendir(dir);
+    int files = 0, fail = 0;
+
+    if (d == NULL)
+    {
+        perror(dir);
+        return 1;
+    }
+    while ((de = readdir(d)) != NULL)
+    {
+        size_t n = strlen(de->d_name), len, got;
+        FILE *f;
+
+        if (n < 5 || strcmp(de->d_name + n - 4, ".irc") != 0) continue;
+        files++;
+        snprintf(path, sizeof(path), "%s/%s", dir, de->d_name);
+        if (cap_load(path, &cap) < 0)
+        {
+            fail++;
+            continue;
+        }
+        len = replay(&cap, out, sizeof(out));
+
+        snprintf(path, sizeof(path), "%s/%.*s.txt", dir, (int)(n - 4), de->d_name);
+        if (update)
+        {
+            f = fopen(path, "w");
+            if (f == NULL) { perror(path); fail++; continue; }
+            fwrite(out, 1, len, f);
+            fclose(f);
+            printf("%-24s updated\n", de->d_name);
+            continue;
+        }
+
+        f = fopen(path, "r");
+        got = f ? fread(want, 1, sizeof(want), f) : 0;
+        if (f) fclose(f);
+        if (f == NULL || got != len || memcmp(out, want, len) != 0)
+        {
+            printf("%-24s FAIL\n", de->d_name);
+            fail++;
+        }
+        else
+        {
+            printf("%-24s ok\n", de->d_name);
+        }
+    }
+    closedir(d);
+    printf("%d files, %d failed\n", files, fail);
+    return (files == 0 || fail) ? 1 : 0;
+}
+
+// 速度: 合成一长串带重复码的帧, 反复喂给解码器
+static int bench(double seconds)
+{
+    IR_Decoder_t dec;
+    struct timespec t0, t1;
+    uint64_t frames = 0, edges = 0;
+    uint32_t code, sink = 0;
+    double dt;
+
+    memset(&cap.head, 0, sizeof(cap.head));
+    while (cap.head.count + 2 * IR_DEC_EDGES < SYNTH_MAX)
+    {
+        synth_frame(&cap, NEC_CODE(synth_rand() & 0xFF, synth_rand() & 0xFF), 40000, 100);
+        synth_repeat(&cap, 40000, 100);
+    }
+
+    IR_Decode_Reset(&dec);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    do
+    {
+        for (uint32_t i = 0; i < cap.head.count; i++)
+        {
+            uint16_t e = cap.edge[i];
+            uint8_t r = IR_Decode_Edge(&dec, IR_CAP_LEVEL(e), IR_CAP_DT(e), &code);
+
+            frames += (r != IR_DEC_NONE);
+            sink += code;
+        }
+        edges += cap.head.count;
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        dt = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) * 1e-9;
+    } while (dt < seconds);
+
+    printf("%llu edges, %llu frames+repeats in %.2f s: %.2f M frames/s, %.2f ns/edge (%08X)\n",
+           (unsigned long long)edges, (unsigned long long)frames, dt,
+           frames / dt * 1e-6, dt * 1e9 / edges, sink);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    static char out[OUT_MAX];
+    const char *save = NULL;
+    int fd;
+
+    if (argc >= 3 && strcmp(argv[1], "-c") == 0)
+        return corpus(argv[2], argc >= 4 && strcmp(argv[3], "-u") == 0);
+
+    if (argc >= 2 && strcmp(argv[1], "-b") == 0)
+        return bench(argc >= 3 ? atof(argv[2]) : 2.0);
+
+    if (argc >= 4 && strcmp(argv[1], "-g") == 0)
+    {
+        if (synth(argv[2], &cap) < 0) return 1;
+        return cap_save(argv[3], &cap) < 0;
+    }
+
+    if (argc >= 3 && strcmp(argv[1], "-f") == 0)
+    {
+        if (cap_load(argv[2], &cap) < 0) return 1;
+    }
+    else if (argc >= 2 && argv[1][0] != '-')
+    {
+        char cmd = IR_CAP_DUMP_CMD;
+
+        if (argc >= 4 && strcmp(argv[2], "-o") == 0) save = argv[3];
+        fd = open(argv[1], O_RDWR | O_NOCTTY);
+        if (fd < 0) { perror(argv[1]); return 1; }
+        set_baud(fd, B115200);
+        tcflush(fd, TCIOFLUSH);
+        if (write(fd, &cmd, 1) != 1 || wait_banner(fd) < 0)
+        {
+            fprintf(stderr, "no dump banner\n");
+            return 1;
+        }
+        if (cap_read(fd, &cap) < 0) return 1;
+        close(fd);
+        if (save && cap_save(save, &cap) < 0) return 1;
+    }
+    else
+    {
+        fprintf(stderr, "usage: %s <tty> [-o cap.irc] | -f cap.irc | -c dir [-u] | -g kind out.irc | -b [s]\n", argv[0]);
+        return 2;
+    }
+
+    fwrite(out, 1, replay(&cap, out, sizeof(out)), stdout);
+    return 0;
+}
@@ -0,0 +1,116 @@
+/************************************************************************
+* TOTP 测试向量和耗时 (Linux 主机端)
+*
+* 编译:  gcc -O2 -I../Inc -o totp_test totp_test.c ../Src/totp.c ../Src/sha1.c
+*        (加 -DSHA1_UNROLL=1 测板子上用的展开版)
+*
+* 用法:  totp_test [次数]
+*
+* 和板子上的 totp.c/sha1.c 是同一份源码. 先核对 RFC 4226 附录 D 的 HOTP
+* 向量 (6 位, 计数 0~9) 和 RFC 6238 附录 B 的 SHA1 向量 (8 位), 再测
+* 1/4/8/16 个访客时一次 Totp_Match (每人前后三步) 的平均耗时.
+* 板子上的周期数见 VISITOR_BENCH_ENABLE (Inc/visitor.h).
+*************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "totp.h"
+
+static const uint8_t rfc_secret[20] = "12345678901234567890";
+
+static const uint32_t hotp_expect[10] =
+{
+    755224, 287082, 359152, 969429, 338314, 254676, 287922, 162583, 399871, 520489
+};
+
+static const struct
+{
+    uint64_t time;
+    uint32_t code;
+} totp_expect[6] =
+{
+    { 59,          94287082 },
+    { 1111111109,  7081804 },
+    { 1111111111,  14050471 },
+    { 1234567890,  89005924 },
+    { 2000000000,  69279037 },
+    { 20000000000ull, 65353130 },
+};
+
+static volatile int32_t sink;
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+int main(int argc, char **argv)
+{
+    static const uint32_t sizes[4] = { 1, 4, 8, 16 };
+    uint32_t loops = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 20000;
+    Totp_Key_t keys[16];
+    int fail = 0;
+    int8_t drift;
+
+    if (loops == 0) loops = 1;
+
+    Totp_Key_Init(&keys[0], rfc_secret, 20, 6);
+    for (uint32_t c = 0; c < 10; c++)
+    {
+        uint32_t code = Totp_Hotp(&keys[0], c);
+        if (code != hotp_expect[c])
+        {
+            printf("HOTP  counter %u: %06u, expected %06u\n", c, code, hotp_expect[c]);
+            fail++;
+        }
+    }
+
+    Totp_Key_Init(&keys[0], rfc_secret, 20, 8);
+    for (int i = 0; i < 6; i++)
+    {
+        uint32_t step = (uint32_t)(totp_expect[i].time / TOTP_STEP_S);
+        uint32_t code = Totp_Hotp(&keys[0], step);
+        if (code != totp_expect[i].code)
+        {
+            printf("TOTP  time %llu: %08u, expected %08u\n",
+                   (unsigned long long)totp_expect[i].time, code, totp_expect[i].code);
+            fail++;
+        }
+        // 窗口: 前一步和后一步的时间也要认, 再远就不认
+        if (Totp_Match(keys, 1, step - 1, totp_expect[i].code, &drift) != 0 || drift != 1 ||
+            Totp_Match(keys, 1, step + 1, totp_expect[i].code, &drift) != 0 || drift != -1 ||
+            Totp_Match(keys, 1, step + 2, totp_expect[i].code, &drift) != -1)
+        {
+            printf("TOTP  time %llu: window check failed\n", (unsigned long long)totp_expect[i].time);
+            fail++;
+        }
+    }
+    printf("RFC 4226/6238 vectors: %s\n", fail ? "FAILED" : "ok");
+    if (fail) return 1;
+
+    // 第一格放 RFC 密钥, 其余随便填; 不命中是最常见的情况 (输错/别人的主密码)
+    for (int i = 1; i < 16; i++)
+    {
+        uint8_t s[20];
+        for (int j = 0; j < 20; j++) s[j] = (uint8_t)(i * 31 + j * 7);
+        Totp_Key_Init(&keys[i], s, 20, 8);
+    }
+
+    printf("visitors   ns/check  (%u loops, %d HMAC per visitor)\n", loops, 2 * TOTP_WINDOW + 1);
+    for (int k = 0; k < 4; k++)
+    {
+        double t0 = now_ns();
+        for (uint32_t i = 0; i < loops; i++)
+        {
+            sink = Totp_Match(keys, sizes[k], 37037037 + i, 12345678, &drift);
+        }
+        printf("%8u %10.1f\n", sizes[k], (now_ns() - t0) / loops);
+    }
+    return 0;
+}